@@ -1,12 +1,209 @@
 #include <bits/stdc++.h>
+#include <fcntl.h>    // open / mmap for on-disk matrices (POSIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
+using ll = long long;
+
+// Dense n x n matrix in one 64-byte aligned block, row-major: row i starts at
+// data + i * ld, with ld rounded up so that every row is aligned too.
+// Copies share the storage, which `hold` keeps alive.
+template <typename T>
+struct FlatMatrix
+{
+    int n = 0;
+    size_t ld = 0;
+    T *data = nullptr;
+    shared_ptr<void> hold;
+
+    static FlatMatrix allocate(int n)
+    {
+        FlatMatrix m;
+        m.n = n;
+        m.ld = ((size_t)n * sizeof(T) + 63) / 64 * 64 / sizeof(T);
+        if (m.ld * sizeof(T) % 4096 == 0)
+            m.ld += 64 / sizeof(T); // a 4 KiB stride maps a tile's rows onto the same cache sets
+        m.data = (T *)aligned_alloc(64, max<size_t>(64, (size_t)n * m.ld * sizeof(T)));
+        if (!m.data)
+            throw bad_alloc();
+        m.hold = shared_ptr<void>(m.data, free);
+        return m;
+    }
+
+    T *operator[](int i) { return data + i * ld; }
+    const T *operator[](int i) const { return data + i * ld; }
+};
+
+// Header of an on-disk all-pairs matrix (written by Graph::floyd_warshall_to_file).
+// Layout, native byte order:
+//   [0, data_offset)  this header, zero padded to a multiple of 4 KiB
+//   then tiles x tiles tiles, tiles = ceil(n / block), of block x block values
+//   (signed integers of value_size bytes); tile (I, J) starts at
+//   data_offset + (I * tiles + J) * block^2 * value_size and holds rows I * block..
+//   and columns J * block.. in row-major order.
+// Entries past n are padding; unreachable pairs hold `inf`. TiledMatrix::open()
+// rejects files whose header breaks these rules or whose tiles do not fit the file.
+struct TiledMatrixHeader
+{
+    char magic[8];       // "CPAPSP1"
+    uint32_t version;    // 1
+    uint32_t value_size; // sizeof(T)
+    int64_t n, block, tiles, data_offset, inf;
+};
+
+// Memory-mapped tile-major matrix in the format above; copies share the mapping.
+template <typename T>
+struct TiledMatrix
+{
+    TiledMatrixHeader h{};
+    T *data = nullptr; // tile (0, 0)
+    shared_ptr<void> hold;
+
+    // new file of n x n entries, mapped read-write (contents zero)
+    static TiledMatrix create(const string &path, int n, int block, T inf)
+    {
+        TiledMatrixHeader h{};
+        memcpy(h.magic, "CPAPSP1", 8);
+        h.version = 1;
+        h.value_size = sizeof(T);
+        h.n = n;
+        h.block = block;
+        h.tiles = (n + block - 1) / block;
+        h.data_offset = 4096;
+        h.inf = inf;
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            throw runtime_error("Cannot create " + path);
+        bool ok = pwrite(fd, &h, sizeof h, 0) == (ssize_t)sizeof h &&
+                  ftruncate(fd, h.data_offset + h.tiles * h.tiles * h.block * h.block * (int64_t)sizeof(T)) == 0;
+        ::close(fd);
+        if (!ok)
+            throw runtime_error("Cannot size " + path);
+        return open(path, true);
+    }
+
+    static TiledMatrix open(const string &path, bool writable = false)
+    {
+        int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0)
+            throw runtime_error("Cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 4096)
+        {
+            ::close(fd);
+            throw runtime_error("Not an APSP matrix: " + path);
+        }
+        size_t size = st.st_size;
+        void *p = mmap(nullptr, size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw runtime_error("Cannot map " + path);
+        TiledMatrix m;
+        m.hold = shared_ptr<void>(p, [size](void *q) { munmap(q, size); });
+        memcpy(&m.h, p, sizeof m.h);
+        if (memcmp(m.h.magic, "CPAPSP1", 8) != 0 || m.h.version != 1 || m.h.value_size != sizeof(T))
+            throw runtime_error("Not an APSP matrix of this type: " + path);
+        // the header comes from whoever wrote the file: check the geometry is consistent,
+        // the data is page aligned and every tile lies inside the mapping, without overflow
+        const TiledMatrixHeader &h = m.h;
+        int64_t data_bytes = 0;
+        bool ok = h.n >= 1 && h.n <= INT_MAX && h.block >= 1 && h.block <= INT_MAX &&
+                  h.tiles == (h.n + h.block - 1) / h.block &&
+                  h.data_offset >= (int64_t)sizeof h && h.data_offset % 4096 == 0 &&
+                  !__builtin_mul_overflow(h.tiles * h.block, h.tiles * h.block, &data_bytes) &&
+                  !__builtin_mul_overflow(data_bytes, (int64_t)sizeof(T), &data_bytes) &&
+                  data_bytes <= (int64_t)size - h.data_offset;
+        if (!ok)
+            throw runtime_error("Corrupt or truncated APSP matrix: " + path);
+        m.data = (T *)((char *)p + m.h.data_offset);
+        return m;
+    }
+
+    T *tile(int I, int J) const { return data + ((size_t)I * h.tiles + J) * h.block * h.block; }
+    T operator()(int i, int j) const { return tile(i / h.block, j / h.block)[(i % h.block) * h.block + j % h.block]; }
+
+    // madvise over the pages covering [p, p + bytes)
+    static void advise(const void *p, size_t bytes, int advice)
+    {
+        uintptr_t b = (uintptr_t)p & ~(uintptr_t)4095, e = ((uintptr_t)p + bytes + 4095) & ~(uintptr_t)4095;
+        madvise((void *)b, e - b, advice);
+    }
+};
+
+// Fixed team of threads for algorithms made of many short parallel phases:
+// run(threads, body) starts the workers once and calls body(team, t) on each (t = 0
+// is the calling thread). Every worker must make the same sequence of for_each calls;
+// for_each(t, count, f) hands out the indices of [0, count) through an atomic
+// counter, calls f(i, t), and returns on each worker only after all of them have
+// finished the phase, so consecutive phases never create threads again.
+// Build with -pthread.
+class WorkerTeam
+{
+public:
+    template <typename B>
+    static void run(int threads, B body)
+    {
+        WorkerTeam team(max(1, threads));
+        vector<thread> pool;
+        for (int t = 1; t < team.size; t++)
+            pool.emplace_back([&, t]
+                              { body(team, t); });
+        body(team, 0);
+        for (auto &th : pool)
+            th.join();
+    }
+
+    template <typename F>
+    void for_each(int t, int count, F f)
+    {
+        // two counters in turn: the idle one is reset for the next phase while this
+        // one is still in use, and the barrier below orders the reset before its use
+        int p = phase[t]++ & 1;
+        if (t == 0)
+            next[p ^ 1] = 0;
+        for (int i; (i = next[p].fetch_add(1)) < count;)
+            f(i, t);
+        wait();
+    }
+
+private:
+    int size, waiting = 0;
+    size_t generation = 0;
+    mutex mu;
+    condition_variable cv;
+    atomic<int> next[2];
+    vector<int> phase;
+
+    explicit WorkerTeam(int threads) : size(threads), phase(threads, 0)
+    {
+        next[0] = next[1] = 0;
+    }
+
+    void wait()
+    {
+        if (size == 1)
+            return;
+        unique_lock<mutex> lock(mu);
+        size_t g = generation;
+        if (++waiting == size)
+        {
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+        }
+        else
+            cv.wait(lock, [&]
+                    { return generation != g; });
+    }
+};
 
 class Graph
 {
 public:
     using ll = long long;
-    const ll INF = 1e18;
-    const int NINF = -1e9;
+    static constexpr ll INF = 1e18;
+    static constexpr int NINF = -1e9;
 
     int n;
     bool directed;
@@ -29,6 +226,55 @@ public:
         }
     }
 
+    // Bulk version of add_edge: counts the batch's degree per row first so every
+    // touched adjacency row grows at most once. Small batches count by sorting their
+    // endpoints (O(k log k)); only a batch with at least n / 2 endpoints pays for an
+    // O(n) count array, so many small batches cost no more than add_edge.
+    void add_edges(const vector<tuple<int, int, ll>> &list)
+    {
+        vector<int> ends;
+        ends.reserve(list.size() * (directed ? 1 : 2));
+        for (auto [u, v, w] : list)
+        {
+            ends.push_back(u);
+            if (!directed)
+                ends.push_back(v);
+        }
+        if (2 * ends.size() >= (size_t)n)
+        {
+            vector<int> extra(n, 0);
+            for (int u : ends)
+                extra[u]++;
+            for (int u = 0; u < n; u++)
+            {
+                if (extra[u])
+                    reserve_more(adj[u], extra[u]);
+            }
+        }
+        else
+        {
+            sort(ends.begin(), ends.end());
+            for (size_t i = 0, j; i < ends.size(); i = j)
+            {
+                for (j = i; j < ends.size() && ends[j] == ends[i]; j++)
+                    ;
+                reserve_more(adj[ends[i]], j - i);
+            }
+        }
+        for (auto [u, v, w] : list)
+            add_edge(u, v, w);
+    }
+
+    // Room for `more` appends, growing at least geometrically so that repeated
+    // batches keep push_back's amortized O(1).
+    template <typename V>
+    static void reserve_more(V &v, size_t more)
+    {
+        size_t need = v.size() + more;
+        if (need > v.capacity())
+            v.reserve(max(need, 2 * v.capacity()));
+    }
+
     vector<tuple<int, int, ll>> get_edge_list() const
     {
         vector<tuple<int, int, ll>> edges;
@@ -182,6 +428,541 @@ public:
         return {dist, next_node};
     }
 
+    static int default_threads()
+    {
+        return max(1u, thread::hardware_concurrency());
+    }
+
+    // Calls f(i, t) for every i in [0, count) from `threads` workers (t = worker
+    // index, 0 is the calling thread), handing out indices through an atomic counter.
+    // Build with -pthread.
+    template <typename F>
+    static void parallel_for(int count, int threads, F f)
+    {
+        atomic<int> next(0);
+        auto work = [&](int t)
+        {
+            for (int i; (i = next.fetch_add(1)) < count;)
+                f(i, t);
+        };
+        vector<thread> pool;
+        for (int t = 1; t < threads; t++)
+            pool.emplace_back(work, t);
+        work(0);
+        for (auto &th : pool)
+            th.join();
+    }
+
+    // Johnson's all-pairs shortest paths, O(nm log n): Bellman-Ford from a virtual
+    // source gives potentials h with w(u, v) + h[u] - h[v] >= 0, then every source
+    // runs Dijkstra on the reweighted graph, spread over `threads` workers.
+    // on_row(s, dist) receives row s (n values, INF if unreachable); it is called
+    // concurrently from the workers and the buffer is reused after it returns.
+    // Returns true (and emits nothing) if the graph has a negative cycle.
+    template <typename F>
+    bool johnson_rows(F on_row, int threads = default_threads())
+    {
+        vector<ll> h(n, 0); // h = 0 is the state after relaxing the virtual source
+        for (int pass = 0;; pass++)
+        {
+            bool updated = false;
+            for (int u = 0; u < n; u++)
+            {
+                for (auto [v, w] : adj[u])
+                {
+                    if (h[u] + w < h[v])
+                    {
+                        h[v] = h[u] + w;
+                        updated = true;
+                    }
+                }
+            }
+            if (!updated)
+                break;
+            if (pass == n - 1)
+                return true;
+        }
+
+        // reweighted graph as flat arrays
+        vector<int> off(n + 1, 0), to;
+        vector<ll> wt;
+        to.reserve(edge_count);
+        wt.reserve(edge_count);
+        for (int u = 0; u < n; u++)
+        {
+            for (auto [v, w] : adj[u])
+            {
+                to.push_back(v);
+                wt.push_back(w + h[u] - h[v]);
+            }
+            off[u + 1] = (int)to.size();
+        }
+
+        threads = max(1, min(threads, n));
+        vector<vector<ll>> dist(threads, vector<ll>(n));
+        vector<vector<pair<ll, int>>> heap(threads);
+        parallel_for(n, threads, [&](int s, int t)
+        {
+            vector<ll> &d = dist[t];
+            vector<pair<ll, int>> &pq = heap[t];
+            fill(d.begin(), d.end(), INF);
+            d[s] = 0;
+            pq.emplace_back(0, s);
+            while (!pq.empty())
+            {
+                pop_heap(pq.begin(), pq.end(), greater<>());
+                auto [du, u] = pq.back();
+                pq.pop_back();
+                if (du != d[u])
+                    continue;
+                for (int k = off[u]; k < off[u + 1]; k++)
+                {
+                    int v = to[k];
+                    if (du + wt[k] < d[v])
+                    {
+                        d[v] = du + wt[k];
+                        pq.emplace_back(d[v], v);
+                        push_heap(pq.begin(), pq.end(), greater<>());
+                    }
+                }
+            }
+            for (int v = 0; v < n; v++)
+            {
+                if (d[v] != INF)
+                    d[v] += h[v] - h[s];
+            }
+            on_row(s, (const ll *)d.data());
+        });
+        return false;
+    }
+
+    // Johnson's algorithm into a flat matrix: {dist, has_negative_cycle}
+    // (dist is empty when there is a negative cycle).
+    pair<FlatMatrix<ll>, bool> johnson(int threads = default_threads())
+    {
+        FlatMatrix<ll> dist = FlatMatrix<ll>::allocate(n);
+        bool has_negative_cycle = johnson_rows([&](int s, const ll *row)
+        {
+            copy(row, row + n, dist[s]);
+        }, threads);
+        if (has_negative_cycle)
+            return {FlatMatrix<ll>(), true};
+        return {dist, false};
+    }
+
+    // One min-plus step on a bs x bs tile: c[i][j] = min(c[i][j], a[i][k] + b[k][j])
+    // for k = 0..bs-1 in order, so it is also correct when c aliases a or b (the
+    // diagonal, row and column tiles of blocked Floyd-Warshall). The j loop has no
+    // branch and vectorizes (compile with -O3 -march=native for AVX2 / AVX-512).
+    template <typename T>
+    static void min_plus_tile(T *c, const T *a, const T *b, int bs, size_t ldc, size_t lda, size_t ldb)
+    {
+        for (int k = 0; k < bs; k++)
+        {
+            const T *bk = b + k * ldb;
+            for (int i = 0; i < bs; i++)
+            {
+                T aik = a[i * lda + k];
+                T *ci = c + i * ldc;
+                for (int j = 0; j < bs; j++)
+                {
+                    T s = aik + bk[j];
+                    ci[j] = s < ci[j] ? s : ci[j];
+                }
+            }
+        }
+    }
+
+    // The same update when c shares no storage with a or b: i-k-j order keeps row
+    // c[i] in cache (or registers) across the whole k loop.
+    template <typename T>
+    static void min_plus_tile_disjoint(T *__restrict c, const T *__restrict a, const T *__restrict b, int bs, size_t ldc, size_t lda, size_t ldb)
+    {
+        for (int i = 0; i < bs; i++)
+        {
+            T *__restrict ci = c + i * ldc;
+            for (int k = 0; k < bs; k++)
+            {
+                T aik = a[i * lda + k];
+                const T *__restrict bk = b + k * ldb;
+                for (int j = 0; j < bs; j++)
+                {
+                    T s = aik + bk[j];
+                    ci[j] = s < ci[j] ? s : ci[j];
+                }
+            }
+        }
+    }
+
+    // Blocked Floyd-Warshall in place on the first N rows / columns of d, where N is a
+    // multiple of bs. For every diagonal tile K: close tile (K, K), then the tiles of
+    // row K and column K, then every other tile (I, J) from (I, K) and (K, J); the tiles
+    // of the last two phases are independent and are spread over `threads` workers,
+    // one WorkerTeam for the whole run with a barrier between phases.
+    template <typename T>
+    static void blocked_floyd_warshall(FlatMatrix<T> &d, int N, int bs, int threads)
+    {
+        int nb = N / bs;
+        auto tile = [&](int I, int J)
+        {
+            return d.data + (size_t)I * bs * d.ld + (size_t)J * bs;
+        };
+        WorkerTeam::run(threads, [&](WorkerTeam &team, int t)
+        {
+            for (int K = 0; K < nb; K++)
+            {
+                team.for_each(t, 1, [&](int, int)
+                {
+                    min_plus_tile(tile(K, K), tile(K, K), tile(K, K), bs, d.ld, d.ld, d.ld);
+                });
+                team.for_each(t, 2 * (nb - 1), [&](int x, int)
+                {
+                    int J = x % (nb - 1) + (x % (nb - 1) >= K);
+                    if (x < nb - 1)
+                        min_plus_tile(tile(K, J), tile(K, K), tile(K, J), bs, d.ld, d.ld, d.ld);
+                    else
+                        min_plus_tile(tile(J, K), tile(J, K), tile(K, K), bs, d.ld, d.ld, d.ld);
+                });
+                team.for_each(t, (nb - 1) * (nb - 1), [&](int x, int)
+                {
+                    int I = x / (nb - 1), J = x % (nb - 1);
+                    I += I >= K;
+                    J += J >= K;
+                    min_plus_tile_disjoint(tile(I, J), tile(I, K), tile(K, J), bs, d.ld, d.ld, d.ld);
+                });
+            }
+        });
+    }
+
+    // "Unreachable" in an all-pairs matrix of T: INF for ll, max / 2 for narrower
+    // types. This is headroom, not saturating arithmetic: the kernels add plainly, so
+    // the sum of two entries fits in T only while finite entries stay below
+    // apsp_inf<T>() / 2 in magnitude (distances_fit<T>()), and a sum involving inf
+    // lands somewhere in [inf / 2, 2 inf] until it is clamped back to inf.
+    template <typename T>
+    static constexpr T apsp_inf()
+    {
+        static_assert(is_integral<T>::value && is_signed<T>::value, "distance type must be a signed integer");
+        return sizeof(T) >= sizeof(ll) ? (T)INF : numeric_limits<T>::max() / 2;
+    }
+
+    // True if a matrix of T can hold every distance: (n - 1) * max |w| < apsp_inf<T>() / 2.
+    template <typename T>
+    bool distances_fit() const
+    {
+        ll max_w = 0;
+        for (int u = 0; u < n; u++)
+        {
+            for (auto [v, w] : adj[u])
+                max_w = max(max_w, w < 0 ? -w : w);
+        }
+        return max_w < (ll)(apsp_inf<T>() / 2) / max(1, n - 1);
+    }
+
+    // Floyd-Warshall distances on one flat matrix, cache-blocked and multithreaded.
+    // Parallel arcs keep the lightest; unreachable pairs are exactly apsp_inf<T>()
+    // (INF for ll). No next_node matrix: apsp_path() rebuilds paths on demand.
+    // A negative dist[i][i] means i lies on a negative cycle.
+    // T = int halves the memory of ll (a third of floyd_warshall's dist + next_node);
+    // the kernels add without saturating and rely on apsp_inf<T>()'s headroom, then
+    // entries >= apsp_inf<T>() / 2 are clamped back to it once the matrix is finished.
+    // That is only exact while distances_fit<T>(), so throws runtime_error otherwise.
+    template <typename T = ll>
+    FlatMatrix<T> floyd_warshall_blocked(int threads = default_threads(), int block = 256 / sizeof(T))
+    {
+        if (!distances_fit<T>())
+            throw runtime_error("Edge weights too large for the distance type");
+        const T inf = apsp_inf<T>();
+        int N = (n + block - 1) / block * block;
+        FlatMatrix<T> dist = FlatMatrix<T>::allocate(N);
+        for (int i = 0; i < N; i++)
+        {
+            fill(dist[i], dist[i] + N, inf);
+            dist[i][i] = 0;
+        }
+        for (int u = 0; u < n; u++)
+        {
+            for (auto [v, w] : adj[u])
+                dist[u][v] = min(dist[u][v], (T)w);
+        }
+        blocked_floyd_warshall(dist, N, block, max(1, threads));
+        // padding rows stay allocated but out of view
+        dist.n = n;
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                if (dist[i][j] >= inf / 2)
+                    dist[i][j] = inf;
+            }
+        }
+        return dist;
+    }
+
+    // Min-plus (tropical) product C[i][j] = min_k A[i][k] + B[k][j] of two n x n
+    // matrices using apsp_inf<T>() for "no path". Both are copied into inf-padded
+    // tiles, then every C tile is accumulated over the k tiles by one worker with the
+    // vectorized min_plus_tile_disjoint. Finite entries must stay within
+    // apsp_inf<T>() / 2 in magnitude; results >= apsp_inf<T>() / 2 become inf.
+    template <typename T>
+    static FlatMatrix<T> min_plus_product(const FlatMatrix<T> &A, const FlatMatrix<T> &B, int threads = default_threads(), int block = 256 / sizeof(T))
+    {
+        const T inf = apsp_inf<T>();
+        int n = A.n, N = (n + block - 1) / block * block, nb = N / block;
+        auto padded = [&](const FlatMatrix<T> &X)
+        {
+            FlatMatrix<T> P = FlatMatrix<T>::allocate(N);
+            for (int i = 0; i < N; i++)
+            {
+                T *tail = i < n ? copy(X[i], X[i] + n, P[i]) : P[i];
+                fill(tail, P[i] + N, inf);
+            }
+            return P;
+        };
+        FlatMatrix<T> a = padded(A), b = padded(B), c = FlatMatrix<T>::allocate(N);
+        parallel_for(nb * nb, max(1, threads), [&](int x, int)
+        {
+            int I = x / nb, J = x % nb;
+            T *ct = c[I * block] + J * block;
+            for (int i = 0; i < block; i++)
+                fill(ct + i * c.ld, ct + i * c.ld + block, inf);
+            for (int K = 0; K < nb; K++)
+                min_plus_tile_disjoint(ct, a[I * block] + K * block, b[K * block] + J * block, block, c.ld, a.ld, b.ld);
+            for (int i = 0; i < block; i++)
+            {
+                for (int j = 0; j < block; j++)
+                {
+                    if (ct[i * c.ld + j] >= inf / 2)
+                        ct[i * c.ld + j] = inf;
+                }
+            }
+        });
+        c.n = n;
+        return c;
+    }
+
+    // Lightest walk of at most k arcs between every pair: the adjacency matrix (0 on
+    // the diagonal, lightest parallel arc) raised to the k-th min-plus power by
+    // repeated squaring, O(n^3 log k). Without negative arcs k is capped at n - 1
+    // (the all-pairs distances). Throws runtime_error unless k * max |w| fits in
+    // apsp_inf<T>() / 2.
+    template <typename T = ll>
+    FlatMatrix<T> shortest_paths_k_hops(int k, int threads = default_threads())
+    {
+        const T inf = apsp_inf<T>();
+        ll max_w = 0;
+        bool negative = false;
+        FlatMatrix<T> base = FlatMatrix<T>::allocate(n), result = FlatMatrix<T>::allocate(n);
+        for (int i = 0; i < n; i++)
+        {
+            fill(base[i], base[i] + n, inf);
+            fill(result[i], result[i] + n, inf);
+            base[i][i] = result[i][i] = 0;
+        }
+        for (int u = 0; u < n; u++)
+        {
+            for (auto [v, w] : adj[u])
+            {
+                base[u][v] = min(base[u][v], (T)w);
+                max_w = max(max_w, w < 0 ? -w : w);
+                negative |= w < 0;
+            }
+        }
+        if (!negative)
+            k = min(k, max(0, n - 1));
+        if (max_w >= (ll)(inf / 2) / max(1, k))
+            throw runtime_error("Edge weights too large for the distance type");
+        for (bool first = true; k > 0; k >>= 1)
+        {
+            if (k & 1)
+            {
+                result = first ? base : min_plus_product(result, base, threads);
+                first = false;
+            }
+            if (k > 1)
+                base = min_plus_product(base, base, threads);
+        }
+        return result;
+    }
+
+    // Distances from s over walks of at most k arcs: k rounds of Bellman-Ford over a
+    // flat arc array, each round relaxing from the previous round's distances only, so
+    // round r is exact for r arcs (in-place relaxation can chain several arcs in one
+    // round). Stops early once a round changes nothing; INF if no such walk. O(km).
+    vector<ll> bellman_ford_k_hops(int s, int k)
+    {
+        vector<int> from, to;
+        vector<ll> wt;
+        from.reserve(edge_count);
+        to.reserve(edge_count);
+        wt.reserve(edge_count);
+        for (int u = 0; u < n; u++)
+        {
+            for (auto [v, w] : adj[u])
+            {
+                from.push_back(u);
+                to.push_back(v);
+                wt.push_back(w);
+            }
+        }
+
+        vector<ll> dist(n, INF), next;
+        dist[s] = 0;
+        for (int round = 0; round < k; round++)
+        {
+            next = dist;
+            bool updated = false;
+            for (size_t e = 0; e < from.size(); e++)
+            {
+                ll du = dist[from[e]];
+                if (du != INF && du + wt[e] < next[to[e]])
+                {
+                    next[to[e]] = du + wt[e];
+                    updated = true;
+                }
+            }
+            dist.swap(next);
+            if (!updated)
+                break;
+        }
+        return dist;
+    }
+
+    // Out-of-core Floyd-Warshall: the same tiled phases over a memory-mapped file in
+    // the TiledMatrixHeader format, for matrices larger than RAM. Every round K reads
+    // and rewrites the file once, tile row by tile row: tile row K and tile column K
+    // are prefetched (MADV_WILLNEED) and stay hot because every other tile uses them,
+    // and each tile row prefetches the next one while it is processed. Tiles are
+    // contiguous, so all I/O is in block^2-value runs.
+    // The tile size comes from memory_budget (bytes): a round keeps about four tile
+    // rows resident (row K, column K, the row being updated and the prefetched next
+    // one), so block = memory_budget / (4 n sizeof(T)), rounded down to a multiple of
+    // 64 and at least 64. Every round reads and writes the whole file, so a run moves
+    // about 2 (n / block) n^2 sizeof(T) bytes: doubling the budget halves the I/O.
+    // When the whole matrix fits in the budget the passes hit the page cache and the
+    // kernels' own block size (as in floyd_warshall_blocked) is used instead.
+    // Returns the read-write mapping of the finished file; TiledMatrix<T>::open()
+    // reads it back (or other tools can mmap it directly). Throws runtime_error on I/O
+    // failure or unless distances_fit<T>().
+    template <typename T = ll>
+    TiledMatrix<T> floyd_warshall_to_file(const string &path, int threads = default_threads(), size_t memory_budget = (size_t)1 << 30)
+    {
+        if (!distances_fit<T>())
+            throw runtime_error("Edge weights too large for the distance type");
+        const T inf = apsp_inf<T>();
+        size_t row_bytes = (size_t)max(1, n) * sizeof(T);
+        int block = (int)(256 / sizeof(T));
+        if (row_bytes * n > memory_budget)
+            block = (int)max<size_t>(64, min<size_t>(memory_budget / (4 * row_bytes), n) / 64 * 64);
+        TiledMatrix<T> m = TiledMatrix<T>::create(path, n, block, inf);
+        int nb = (int)m.h.tiles, bs = block;
+        size_t tile_bytes = (size_t)bs * bs * sizeof(T);
+        threads = max(1, threads);
+
+        parallel_for(nb * nb, threads, [&](int x, int)
+        {
+            int I = x / nb, J = x % nb;
+            T *t = m.tile(I, J);
+            fill(t, t + (size_t)bs * bs, inf);
+            if (I == J)
+            {
+                for (int i = 0; i < bs; i++)
+                    t[i * bs + i] = 0;
+            }
+        });
+        for (int u = 0; u < n; u++)
+        {
+            for (auto [v, w] : adj[u])
+            {
+                T &d = m.tile(u / bs, v / bs)[(u % bs) * bs + v % bs];
+                d = min(d, (T)w);
+            }
+        }
+
+        WorkerTeam::run(threads, [&](WorkerTeam &team, int t)
+        {
+            for (int K = 0; K < nb; K++)
+            {
+                T *kk = m.tile(K, K);
+                team.for_each(t, 1, [&](int, int)
+                {
+                    TiledMatrix<T>::advise(m.tile(K, 0), nb * tile_bytes, MADV_WILLNEED);
+                    for (int I = 0; I < nb; I++)
+                        TiledMatrix<T>::advise(m.tile(I, K), tile_bytes, MADV_WILLNEED);
+                    min_plus_tile(kk, kk, kk, bs, bs, bs, bs);
+                });
+                team.for_each(t, 2 * (nb - 1), [&](int x, int)
+                {
+                    int J = x % (nb - 1) + (x % (nb - 1) >= K);
+                    if (x < nb - 1)
+                        min_plus_tile(m.tile(K, J), kk, m.tile(K, J), bs, bs, bs, bs);
+                    else
+                        min_plus_tile(m.tile(J, K), m.tile(J, K), kk, bs, bs, bs, bs);
+                });
+                // the rest in file order; the first tile of each tile row prefetches the next row
+                team.for_each(t, nb * nb, [&](int x, int)
+                {
+                    int I = x / nb, J = x % nb;
+                    if (J == 0 && I + 1 < nb)
+                        TiledMatrix<T>::advise(m.tile(I + 1, 0), nb * tile_bytes, MADV_WILLNEED);
+                    if (I != K && J != K)
+                        min_plus_tile_disjoint(m.tile(I, J), m.tile(I, K), m.tile(K, J), bs, bs, bs, bs);
+                });
+            }
+        });
+
+        parallel_for(nb * nb, threads, [&](int x, int)
+        {
+            T *t = m.tile(x / nb, x % nb);
+            for (size_t i = 0; i < (size_t)bs * bs; i++)
+            {
+                if (t[i] >= inf / 2)
+                    t[i] = inf;
+            }
+        });
+        if (msync(m.hold.get(), m.h.data_offset + nb * nb * tile_bytes, MS_SYNC) != 0)
+            throw runtime_error("Cannot write " + path);
+        return m;
+    }
+
+    // Shortest path s..t rebuilt from an all-pairs distance matrix and the adjacency
+    // lists: follow tight arcs, w(u, v) + dist[v][t] == dist[u][t], depth-first with
+    // a visited mark so zero-weight cycles cannot trap the walk. Empty if t is
+    // unreachable or no tight walk exists (negative cycles).
+    template <typename T>
+    vector<int> apsp_path(const FlatMatrix<T> &dist, int s, int t) const
+    {
+        const T inf = apsp_inf<T>();
+        if (dist[s][t] >= inf)
+            return {};
+        vector<char> seen(n, 0);
+        vector<int> path{s};
+        vector<size_t> next_arc{0};
+        seen[s] = 1;
+        while (!path.empty() && path.back() != t)
+        {
+            int u = path.back();
+            size_t &k = next_arc.back();
+            int step = -1;
+            for (; k < adj[u].size() && step == -1; k++)
+            {
+                auto [v, w] = adj[u][k];
+                if (!seen[v] && dist[v][t] < inf && w + dist[v][t] == (ll)dist[u][t])
+                    step = v;
+            }
+            if (step == -1)
+            {
+                path.pop_back();
+                next_arc.pop_back();
+                continue;
+            }
+            seen[step] = 1;
+            path.push_back(step);
+            next_arc.push_back(0);
+        }
+        return path;
+    }
+
     vector<int> topological_sort()
     {
         vector<int> in_degree(n, 0);
@@ -496,6 +1277,19 @@ int main()
         cout << "\n";
     }
 
+    // Johnson's algorithm gives the same matrix from one Dijkstra per source
+    auto [dist_js, neg_js] = g3.johnson();
+    cout << "\nJohnson (same matrix):\n";
+    for (int i = 0; i < 3 && !neg_js; i++)
+    {
+        cout << "From " << i << ": ";
+        for (int j = 0; j < 3; j++)
+        {
+            cout << (dist_js[i][j] == Graph::INF ? "INF" : to_string(dist_js[i][j])) << " ";
+        }
+        cout << "\n";
+    }
+
     // Example 4: Graph with SCCs (Kosaraju)
     cout << "\nExample 4: Strongly Connected Components\n";
     Graph g4(5, true);
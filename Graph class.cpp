@@ -1,8 +1,12 @@
 // graph_cp_explained.cpp
 // Single-file, readable and efficient Graph utilities for Competitive Programming.
-// C++17, compile with: g++ -std=c++17 -O2 graph_cp_explained.cpp -o solution
+// C++17, compile with: g++ -std=c++17 -O2 -pthread graph_cp_explained.cpp -o solution
 
 #include <bits/stdc++.h>
+#include <fcntl.h>      // open / mmap for CSR snapshots (POSIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 using ll = long long;
 
@@ -10,6 +14,10 @@ template<typename W = long long>
 struct Graph {
     // ---------- Types ----------
     struct Edge { int u, v; W w; int id; Edge(int a = 0, int b = 0, W c = 1, int i = -1): u(a), v(b), w(c), id(i) {} };
+    // priority queue used by dijkstra()
+    enum class SSSPQueue { LazyBinary, IndexedDAry, RadixHeap, DialBuckets, Auto };
+    // traversal used by the early-terminating searches (BFS counts hops, ZeroOneBFS expects 0/1 weights)
+    enum class SearchKind { BFS, Dijkstra, ZeroOneBFS };
     int n;
     bool directed;
     vector<vector<pair<int, W>>> adj;  // adjacency list: (to, weight)
@@ -35,6 +43,1281 @@ struct Graph {
         }
     }
 
+    // ---------- Bulk add ----------
+    // Same result as addEdge on every entry, but the batch's degree per row is counted first
+    // so each touched row (and `edges`) grows at most once. Counting costs O(k log k) for a
+    // batch of k edges (sorted endpoints) and only switches to an O(n) count array once the
+    // batch is at least that large, so many small batches stay as cheap as addEdge.
+    void addEdges(const vector<Edge>& list) {
+        vector<int> ends; size_t valid = 0;
+        ends.reserve(list.size() * (directed ? 1 : 2));
+        for (auto &e : list) if (e.u >= 0 && e.u < n && e.v >= 0 && e.v < n) { ends.push_back(e.u); if (!directed) ends.push_back(e.v); valid++; }
+        if (2 * ends.size() >= (size_t)n) {
+            vector<int> extra(n, 0);
+            for (int u : ends) extra[u]++;
+            for (int u = 0; u < n; ++u) if (extra[u]) reserveMore(adj[u], extra[u]);
+        } else {
+            sort(ends.begin(), ends.end());
+            for (size_t i = 0, j; i < ends.size(); i = j) {
+                for (j = i; j < ends.size() && ends[j] == ends[i]; ++j) {}
+                reserveMore(adj[ends[i]], j - i);
+            }
+        }
+        reserveMore(edges, valid);
+        for (auto &e : list) addEdge(e.u, e.v, e.w, e.id);
+    }
+    // room for `more` appends; grows at least geometrically so repeated batches stay amortized O(1)
+    template<class V> static void reserveMore(V& v, size_t more) {
+        size_t need = v.size() + more;
+        if (need > v.capacity()) v.reserve(max(need, 2 * v.capacity()));
+    }
+    static Graph buildFromEdgeList(int nodes, bool isDirected, const vector<Edge>& list) {
+        Graph g(nodes, isDirected); g.addEdges(list); return g;
+    }
+
+    // ---------- Threading helpers ----------
+    static int hardwareThreads() { return max(1, (int)thread::hardware_concurrency()); }
+    // run f(t) for t in [0, threads); t = 0 runs on the calling thread
+    template<class F> static void runThreads(int threads, F f) {
+        vector<thread> pool;
+        for (int t = 1; t < threads; ++t) pool.emplace_back(f, t);
+        f(0);
+        for (auto &th : pool) th.join();
+    }
+    // f(i, t) for every i in [0, count), handed out in dynamic slices to `threads` threads
+    template<class F> static void parallelFor(int threads, ll count, F f, ll slice = 1024) {
+        atomic<ll> next{0};
+        runThreads(max(1, (int)min<ll>(threads, (count + slice - 1) / slice)), [&](int t) {
+            for (ll b; (b = next.fetch_add(slice, memory_order_relaxed)) < count; )
+                for (ll i = b, e = min(count, b + slice); i < e; ++i) f(i, t);
+        });
+    }
+    // reusable barrier for a fixed team of threads (C++17 has no std::barrier)
+    struct Barrier {
+        mutex mu; condition_variable cv; int count, waiting = 0; size_t gen = 0;
+        explicit Barrier(int c) : count(c) {}
+        void wait() {
+            unique_lock<mutex> lk(mu); size_t g = gen;
+            if (++waiting == count) { waiting = 0; ++gen; cv.notify_all(); }
+            else cv.wait(lk, [&] { return gen != g; });
+        }
+    };
+
+    // ---------- Reusable traversal workspace ----------
+    // Scratch state for many small queries, one per thread. Marks carry an epoch stamp, so a
+    // new query starts in O(1) and only the vertices it reaches are ever written: a query that
+    // explores k vertices costs O(k), not O(n). Results live in the workspace until the next
+    // query; `touched` lists the reached vertices in the order they were first reached.
+    struct Workspace {
+        vector<unsigned> stamp, done; unsigned epoch = 0;
+        vector<W> d; vector<int> par, touched;
+        vector<int> q; deque<int> dq; vector<pair<W, int>> heap;
+        void begin(int n) {
+            if ((int)stamp.size() < n) { stamp.resize(n, 0); done.resize(n, 0); d.resize(n); par.resize(n); }
+            if (++epoch == 0) { fill(stamp.begin(), stamp.end(), 0); fill(done.begin(), done.end(), 0); epoch = 1; }  // stamps wrapped around
+            touched.clear(); q.clear(); dq.clear(); heap.clear();
+        }
+        bool seen(int v) const { return stamp[v] == epoch; }
+        // true the first time v is settled in this query
+        bool settle(int v) { if (done[v] == epoch) return false; done[v] = epoch; return true; }
+        void set(int v, W dist, int parent) {
+            if (stamp[v] != epoch) { stamp[v] = epoch; touched.push_back(v); }
+            d[v] = dist; par[v] = parent;
+        }
+        W dist(int v, W unreached = numeric_limits<W>::max() / 4) const { return seen(v) ? d[v] : unreached; }
+        int parent(int v) const { return seen(v) ? par[v] : -1; }
+    };
+
+    // ---------- Flat component labelling ----------
+    // comp[v] is the component of v; the members of component c are members[off[c] .. off[c+1])
+    // (a CSR of components, ascending vertex order inside each). Three flat arrays instead of
+    // one vector per component.
+    struct Components {
+        int count = 0; vector<int> comp, off, members;
+        // labels must be 0..k-1
+        static Components fromLabels(vector<int> labels) {
+            Components c; c.comp = move(labels);
+            for (int x : c.comp) c.count = max(c.count, x + 1);
+            c.off.assign(c.count + 1, 0);
+            for (int x : c.comp) c.off[x + 1]++;
+            for (int i = 0; i < c.count; ++i) c.off[i + 1] += c.off[i];
+            c.members.resize(c.comp.size());
+            vector<int> cur(c.off.begin(), c.off.end() - 1);
+            for (int v = 0; v < (int)c.comp.size(); ++v) c.members[cur[c.comp[v]]++] = v;
+            return c;
+        }
+        int size(int c) const { return off[c + 1] - off[c]; }
+        const int* begin(int c) const { return members.data() + off[c]; }
+        const int* end(int c) const { return members.data() + off[c + 1]; }
+    };
+
+    // ---------- Landmark distance tables (ALT) ----------
+    // For k landmarks L_i, fwd[v*k + i] = d(L_i, v) and bwd[v*k + i] = d(v, L_i), stored per
+    // vertex so one heuristic call reads two runs of k values. The triangle inequality gives
+    //   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+    // for every landmark; the largest bound is an admissible, consistent A* heuristic. When
+    // the tables prove t unreachable from v, bound() returns INF. Built by CSR::landmarks().
+    struct Landmarks {
+        int n = 0, k = 0; vector<int> ids; vector<W> fwd, bwd;
+        W bound(int v, int t) const {
+            const W INF = numeric_limits<W>::max() / 4;
+            const W *fv = fwd.data() + (ll)v * k, *ft = fwd.data() + (ll)t * k, *bv = bwd.data() + (ll)v * k, *bt = bwd.data() + (ll)t * k;
+            W h = 0;
+            for (int i = 0; i < k; ++i) {
+                if (fv[i] < INF) { if (ft[i] >= INF) return INF; h = max(h, ft[i] - fv[i]); }
+                if (bt[i] < INF) { if (bv[i] >= INF) return INF; h = max(h, bv[i] - bt[i]); }
+            }
+            return h;
+        }
+        auto heuristic(int t) const { return [this, t](int v) { return bound(v, t); }; }
+    };
+
+    // ---------- Read-only file mapping ----------
+    // The whole file mapped with mmap; the mapping lives until the last copy of `hold` dies.
+    struct MappedFile {
+        const char* data = nullptr; size_t size = 0; shared_ptr<const void> hold;
+        static MappedFile open(const string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw runtime_error("cannot open " + path);
+            struct stat st; if (fstat(fd, &st) != 0) { ::close(fd); throw runtime_error("cannot stat " + path); }
+            MappedFile f; f.size = (size_t)st.st_size;
+            if (f.size == 0) { ::close(fd); return f; }
+            void* p = mmap(nullptr, f.size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) throw runtime_error("cannot mmap " + path);
+            size_t len = f.size;
+            f.data = (const char*)p;
+            f.hold = shared_ptr<const void>(p, [len](const void* q) { munmap(const_cast<void*>(q), len); });
+            return f;
+        }
+    };
+
+    // ---------- Frozen CSR graph ----------
+    // Immutable compressed-sparse-row form: the arcs of u are [off[u], off[u+1]) in to / wt
+    // (and eid when edge ids are known). Rows are contiguous, so a neighbor scan streams
+    // through memory instead of chasing one heap block per vertex. Copies are cheap, the
+    // arrays live in shared storage kept alive by `hold`.
+    struct CSR {
+        struct Row {
+            const int* t; const W* w; int sz;
+            struct It {
+                const int* t; const W* w;
+                pair<int, W> operator*() const { return {*t, *w}; }
+                It& operator++() { ++t; ++w; return *this; }
+                bool operator!=(const It& o) const { return t != o.t; }
+            };
+            It begin() const { return {t, w}; }
+            It end() const { return {t + sz, w + sz}; }
+            int size() const { return sz; }
+            pair<int, W> operator[](int i) const { return {t[i], w[i]}; }
+        };
+        struct Arrays { vector<ll> off; vector<int> to; vector<W> wt; vector<int> eid; };
+
+        int n = 0; ll m = 0; bool directed = false;   // m = number of stored arcs
+        const ll* off = nullptr; const int* to = nullptr; const W* wt = nullptr; const int* eid = nullptr;
+        shared_ptr<const void> hold;
+        struct Cache { once_flag revOnce; unique_ptr<CSR> rev; };  // derived data shared by all copies
+        shared_ptr<Cache> cache = make_shared<Cache>();
+
+        // take ownership of filled arrays (off must have n+1 entries)
+        static CSR adopt(shared_ptr<Arrays> a, bool isDirected) {
+            CSR g; g.n = (int)a->off.size() - 1; g.m = a->off.back(); g.directed = isDirected;
+            g.off = a->off.data(); g.to = a->to.data(); g.wt = a->wt.data();
+            g.eid = a->eid.empty() ? nullptr : a->eid.data();
+            g.hold = move(a);
+            return g;
+        }
+        int size() const { return n; }
+        int degree(int u) const { return int(off[u + 1] - off[u]); }
+        Row operator[](int u) const { return {to + off[u], wt + off[u], degree(u)}; }
+
+        // ---------- Bulk build (two-pass counting sort) ----------
+        // Straight from an edge list to exact-sized CSR arrays: count degrees, prefix-sum,
+        // scatter. Rows keep input order, so the result equals buildFromEdgeList on a Graph
+        // followed by freeze(). Edges with out-of-range endpoints are skipped like addEdge.
+        static CSR buildFromEdgeList(int nodes, bool isDirected, const vector<Edge>& list, int threads = 1) {
+            // one private count array per block, so cap the blocks to keep them below the edge list in size
+            ll m = (ll)list.size();
+            int B = (int)max<ll>(1, min<ll>(threads, m / max(nodes, 1)));
+            vector<pair<const Edge*, const Edge*>> blocks;
+            for (int b = 0; b < B; ++b) blocks.push_back({list.data() + m * b / B, list.data() + m * (b + 1) / B});
+            return buildFromEdgeBlocks(nodes, isDirected, blocks);
+        }
+        // the blocks are counted and scattered in parallel, one thread each, in block order
+        static CSR buildFromEdgeBlocks(int nodes, bool isDirected, const vector<pair<const Edge*, const Edge*>>& blocks) {
+            int B = (int)blocks.size();
+            auto ok = [nodes](const Edge & e) { return e.u >= 0 && e.u < nodes && e.v >= 0 && e.v < nodes; };
+            vector<vector<ll>> cur(B); vector<char> hasId(B, 0);
+            runThreads(B, [&](int b) {
+                cur[b].assign(nodes, 0);
+                for (auto e = blocks[b].first; e != blocks[b].second; ++e) if (ok(*e)) {
+                        cur[b][e->u]++; if (!isDirected) cur[b][e->v]++;
+                        if (e->id != -1) hasId[b] = 1;
+                    }
+            });
+            // prefix sums in (vertex, block) order: cur[b][u] becomes block b's first slot in row u
+            auto a = make_shared<Arrays>();
+            a->off.assign(nodes + 1, 0);
+            for (int u = 0; u < nodes; ++u) {
+                ll s = a->off[u];
+                for (int b = 0; b < B; ++b) { ll c = cur[b][u]; cur[b][u] = s; s += c; }
+                a->off[u + 1] = s;
+            }
+            ll m = a->off[nodes];
+            a->to.resize(m); a->wt.resize(m);
+            bool ids = count(hasId.begin(), hasId.end(), 1) > 0;
+            if (ids) a->eid.resize(m);
+            runThreads(B, [&](int b) {
+                auto &c = cur[b];
+                auto put = [&](int u, int v, const Edge & e) { ll k = c[u]++; a->to[k] = v; a->wt[k] = e.w; if (ids) a->eid[k] = e.id; };
+                for (auto e = blocks[b].first; e != blocks[b].second; ++e) if (ok(*e)) {
+                        put(e->u, e->v, *e);
+                        if (!isDirected) put(e->v, e->u, *e);
+                    }
+            });
+            return adopt(a, isDirected);
+        }
+
+        // ---------- Binary snapshot ----------
+        // Versioned on-disk image of the CSR arrays. All sections are 64-byte aligned so
+        // load() can point straight into an mmap of the file: no parsing, copying or per-edge
+        // work, and processes loading the same file share its page cache.
+        //   Header | off[n+1] int64 | to[m] int32 | wt[m] W | eid[m] int32 (only if flags & 2)
+        struct SnapshotHeader {
+            char magic[8];                     // "CPGRAPH"
+            uint32_t version;                  // SNAPSHOT_VERSION
+            uint32_t flags;                    // 1 = directed, 2 = has edge ids
+            uint32_t weightSize, weightKind;   // sizeof(W); 0 = signed int, 1 = unsigned int, 2 = floating
+            int64_t n, m;
+            int64_t offPos, toPos, wtPos, eidPos;  // byte offsets of the sections (eidPos = 0 if absent)
+        };
+        static constexpr uint32_t SNAPSHOT_VERSION = 1;
+        static uint32_t weightKind() { return is_floating_point<W>::value ? 2 : is_signed<W>::value ? 0 : 1; }
+        static int64_t align64(int64_t x) { return (x + 63) & ~int64_t(63); }
+
+        void save(const string& path) const {
+            SnapshotHeader h{};
+            memcpy(h.magic, "CPGRAPH", 8);
+            h.version = SNAPSHOT_VERSION; h.flags = (directed ? 1 : 0) | (eid ? 2 : 0);
+            h.weightSize = sizeof(W); h.weightKind = weightKind(); h.n = n; h.m = m;
+            h.offPos = align64(sizeof h);
+            h.toPos = align64(h.offPos + (n + 1) * (int64_t)sizeof(ll));
+            h.wtPos = align64(h.toPos + m * (int64_t)sizeof(int));
+            h.eidPos = eid ? align64(h.wtPos + m * (int64_t)sizeof(W)) : 0;
+            ofstream out(path, ios::binary | ios::trunc);
+            if (!out) throw runtime_error("cannot write " + path);
+            auto section = [&](int64_t pos, const void* p, int64_t bytes) {
+                static const char zeros[64] = {};
+                out.write(zeros, pos - (int64_t)out.tellp());
+                out.write((const char*)p, bytes);
+            };
+            out.write((const char*)&h, sizeof h);
+            section(h.offPos, off, (n + 1) * (int64_t)sizeof(ll));
+            section(h.toPos, to, m * (int64_t)sizeof(int));
+            section(h.wtPos, wt, m * (int64_t)sizeof(W));
+            if (eid) section(h.eidPos, eid, m * (int64_t)sizeof(int));
+            if (!out) throw runtime_error("write failed: " + path);
+        }
+        // zero-copy: the returned CSR reads the mapped file directly and keeps it mapped
+        // Section bounds and alignment are checked in O(1) and off[] in O(n), so a corrupt file
+        // throws runtime_error instead of mapping out of range. verifyArcs also checks that every
+        // to[] entry is a vertex: one pass over the arcs that faults in the whole section, so it
+        // is off by default and worth it only for files from untrusted sources.
+        static CSR load(const string& path, bool verifyArcs = false) {
+            MappedFile f = MappedFile::open(path);
+            SnapshotHeader h;
+            if (f.size < sizeof h) throw runtime_error("not a graph snapshot: " + path);
+            memcpy(&h, f.data, sizeof h);
+            if (memcmp(h.magic, "CPGRAPH", 8) != 0) throw runtime_error("not a graph snapshot: " + path);
+            if (h.version != SNAPSHOT_VERSION) throw runtime_error("unsupported snapshot version in " + path);
+            if (h.weightSize != sizeof(W) || h.weightKind != weightKind()) throw runtime_error("weight type mismatch in " + path);
+            // every section must lie inside the file, aligned for its element type, before any
+            // pointer into the mapping is handed out; then off[] must describe the rows
+            auto corrupt = [&]() { throw runtime_error("corrupt or truncated snapshot: " + path); };
+            if (h.n < 0 || h.n > INT_MAX || h.m < 0) corrupt();
+            auto section = [&](int64_t pos, int64_t count, int64_t size, int64_t align) {
+                if (pos < (int64_t)sizeof h || pos > (int64_t)f.size || pos % align != 0 || count > ((int64_t)f.size - pos) / size) corrupt();
+            };
+            section(h.offPos, h.n + 1, sizeof(ll), alignof(ll));
+            section(h.toPos, h.m, sizeof(int), alignof(int));
+            section(h.wtPos, h.m, sizeof(W), alignof(W));
+            if (h.flags & 2) section(h.eidPos, h.m, sizeof(int), alignof(int));
+            CSR g; g.n = (int)h.n; g.m = h.m; g.directed = h.flags & 1;
+            g.off = (const ll*)(f.data + h.offPos); g.to = (const int*)(f.data + h.toPos);
+            g.wt = (const W*)(f.data + h.wtPos); g.eid = (h.flags & 2) ? (const int*)(f.data + h.eidPos) : nullptr;
+            if (g.off[0] != 0 || g.off[g.n] != g.m) corrupt();
+            for (int u = 0; u < g.n; ++u) if (g.off[u] > g.off[u + 1]) corrupt();
+            if (verifyArcs) for (ll k = 0; k < g.m; ++k) if ((unsigned)g.to[k] >= (unsigned)g.n) corrupt();
+            g.hold = f.hold;
+            return g;
+        }
+
+        // every stored arc as an Edge (for undirected graphs both directions appear)
+        vector<Edge> arcs() const {
+            vector<Edge> out; out.reserve(m);
+            for (int u = 0; u < n; ++u) for (ll k = off[u]; k < off[u + 1]; ++k) out.emplace_back(u, to[k], wt[k], eid ? eid[k] : -1);
+            return out;
+        }
+
+        // ---------- Reverse graph ----------
+        // transpose(): every arc u->v becomes v->u (row v lists its sources in increasing order).
+        // reverse(): the in-arc view used by bottom-up and backward searches; for undirected graphs
+        // that is the graph itself, for directed ones the transpose is built once and cached.
+        CSR transpose() const {
+            auto a = make_shared<Arrays>();
+            a->off.assign(n + 1, 0);
+            for (ll k = 0; k < m; ++k) a->off[to[k] + 1]++;
+            for (int v = 0; v < n; ++v) a->off[v + 1] += a->off[v];
+            a->to.resize(m); a->wt.resize(m); if (eid) a->eid.resize(m);
+            vector<ll> cur(a->off.begin(), a->off.end() - 1);
+            for (int u = 0; u < n; ++u) for (ll k = off[u]; k < off[u + 1]; ++k) {
+                    ll j = cur[to[k]]++;
+                    a->to[j] = u; a->wt[j] = wt[k]; if (eid) a->eid[j] = eid[k];
+                }
+            return adopt(a, directed);
+        }
+        CSR reverse() const {
+            if (!directed) return *this;
+            call_once(cache->revOnce, [&] { cache->rev.reset(new CSR(transpose())); });
+            return *cache->rev;
+        }
+
+        // ---------- Direction-optimizing BFS ----------
+        // Beamer-style hybrid: levels run top-down from a queue while the frontier is small, and
+        // switch to bottom-up (every unvisited vertex scans its in-arcs for a parent in the
+        // frontier bitmap and stops at the first hit) once the arcs leaving the frontier exceed
+        // 1/alpha of the arcs not yet explored. Back to top-down when the frontier shrinks below
+        // n/beta. Returns {dist, parent} like a BFS (-1 = unreachable / no parent); parent[v] is
+        // a BFS-tree parent, not necessarily the one a queue BFS would pick.
+        pair<vector<int>, vector<int>> directionOptimizingBFS(int src, int alpha = 15, int beta = 18) const {
+            vector<int> dist(n, -1), parent(n, -1);
+            if (src < 0 || src >= n) return {dist, parent};
+            CSR in = reverse();
+            int words = (n + 63) / 64;
+            vector<uint64_t> front(words), next(words);
+            vector<int> queue{src}, nxt;
+            dist[src] = 0;
+            ll edgesToCheck = m, scoutCount = degree(src);
+            while (!queue.empty()) {
+                if (scoutCount > edgesToCheck / alpha) {
+                    fill(front.begin(), front.end(), 0);
+                    for (int u : queue) front[u >> 6] |= 1ULL << (u & 63);
+                    ll awake = (ll)queue.size(), oldAwake;
+                    do { // bottom-up step
+                        oldAwake = awake; awake = 0;
+                        fill(next.begin(), next.end(), 0);
+                        for (int v = 0; v < n; ++v) {
+                            if (dist[v] != -1) continue;
+                            for (ll k = in.off[v]; k < in.off[v + 1]; ++k) {
+                                int u = in.to[k];
+                                if (front[u >> 6] >> (u & 63) & 1) {
+                                    parent[v] = u; dist[v] = dist[u] + 1;
+                                    next[v >> 6] |= 1ULL << (v & 63); ++awake;
+                                    break;
+                                }
+                            }
+                        }
+                        swap(front, next);
+                    } while (awake >= oldAwake || awake > n / beta);
+                    queue.clear();
+                    for (int w = 0; w < words; ++w) for (uint64_t b = front[w]; b; b &= b - 1) queue.push_back(w * 64 + __builtin_ctzll(b));
+                    scoutCount = 1;
+                } else { // top-down step
+                    edgesToCheck -= scoutCount; scoutCount = 0;
+                    nxt.clear();
+                    for (int u : queue) for (ll k = off[u]; k < off[u + 1]; ++k) {
+                            int v = to[k];
+                            if (dist[v] == -1) { dist[v] = dist[u] + 1; parent[v] = u; nxt.push_back(v); scoutCount += degree(v); }
+                        }
+                    swap(queue, nxt);
+                }
+            }
+            return {dist, parent};
+        }
+
+        // ---------- Parallel BFS (level-synchronous) ----------
+        // One team of threads walks the levels in lockstep. Each level the threads pull 64-vertex
+        // slices of the frontier, claim undiscovered neighbors with a CAS on dist (the winner
+        // writes parent) and append them to a private next-frontier buffer; the buffers are then
+        // concatenated in parallel into the next frontier. Returns {dist, parent}; parent[v] is a
+        // BFS-tree parent, which one depends on scheduling.
+        pair<vector<int>, vector<int>> parallelBFS(int src, int threads = hardwareThreads()) const {
+            vector<int> dist(n, -1), parent(n, -1);
+            if (src < 0 || src >= n) return {dist, parent};
+            int T = max(1, threads), level = 0;
+            vector<int> frontier{src};
+            vector<vector<int>> local(T); vector<size_t> pos(T + 1, 0);
+            atomic<size_t> cursor{0};
+            Barrier bar(T);
+            dist[src] = 0;
+            runThreads(T, [&](int t) {
+                const size_t SLICE = 64;
+                while (true) {
+                    size_t F = frontier.size();
+                    local[t].clear();
+                    for (size_t b; (b = cursor.fetch_add(SLICE, memory_order_relaxed)) < F; )
+                        for (size_t i = b; i < min(F, b + SLICE); ++i) {
+                            int u = frontier[i];
+                            for (ll k = off[u]; k < off[u + 1]; ++k) {
+                                int v = to[k], unseen = -1;
+                                if (__atomic_load_n(&dist[v], __ATOMIC_RELAXED) == -1 &&
+                                        __atomic_compare_exchange_n(&dist[v], &unseen, level + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                                    parent[v] = u; local[t].push_back(v);
+                                }
+                            }
+                        }
+                    bar.wait();
+                    if (t == 0) {
+                        for (int i = 0; i < T; ++i) pos[i + 1] = pos[i] + local[i].size();
+                        frontier.resize(pos[T]); cursor = 0; ++level;
+                    }
+                    bar.wait();
+                    if (frontier.empty()) break;
+                    copy(local[t].begin(), local[t].end(), frontier.begin() + pos[t]);
+                    bar.wait();
+                }
+            });
+            return {dist, parent};
+        }
+
+        // ---------- Bit-parallel multi-source BFS (MS-BFS) ----------
+        // Runs 64 * WORDS independent BFS traversals at once: every vertex keeps bitsets of the
+        // sources that have seen it / visit it this level, so one scan of a row advances all of
+        // them together (WORDS = 4 gives 256 sources per scan in SIMD-friendly words).
+        // msbfs streams the result: onVisit(level, v, first, mask) is called once per vertex and
+        // level with mask[WORDS] = the sources reaching v at that distance, where bit b of
+        // mask[w] stands for sources[first + 64 * w + b]. Out-of-range sources are ignored.
+        template<int WORDS = 1, class F> void msbfs(const vector<int>& sources, F onVisit) const {
+            vector<uint64_t> seen, visit, next;
+            const int B = 64 * WORDS;
+            for (int first = 0; first < (int)sources.size(); first += B)
+                msbfsBatch<WORDS>(sources.data() + first, min(B, (int)sources.size() - first), first, onVisit, seen, visit, next);
+        }
+        template<int WORDS, class F> void msbfsBatch(const int* src, int cnt, int first, F& onVisit,
+                vector<uint64_t>& seen, vector<uint64_t>& visit, vector<uint64_t>& next) const {
+            seen.assign((size_t)n * WORDS, 0); visit.assign((size_t)n * WORDS, 0); next.assign((size_t)n * WORDS, 0);
+            for (int i = 0; i < cnt; ++i) if (src[i] >= 0 && src[i] < n) {
+                    seen[(size_t)src[i] * WORDS + i / 64] |= 1ULL << (i % 64);
+                    visit[(size_t)src[i] * WORDS + i / 64] |= 1ULL << (i % 64);
+                }
+            for (int v = 0; v < n; ++v) {
+                const uint64_t* x = &visit[(size_t)v * WORDS]; uint64_t any = 0;
+                for (int w = 0; w < WORDS; ++w) any |= x[w];
+                if (any) onVisit(0, v, first, x);
+            }
+            for (int level = 1;; ++level) {
+                bool active = false;
+                for (int u = 0; u < n; ++u) {
+                    const uint64_t* vu = &visit[(size_t)u * WORDS]; uint64_t any = 0;
+                    for (int w = 0; w < WORDS; ++w) any |= vu[w];
+                    if (!any) continue;
+                    for (ll k = off[u]; k < off[u + 1]; ++k) {
+                        uint64_t* nx = &next[(size_t)to[k] * WORDS]; const uint64_t* sv = &seen[(size_t)to[k] * WORDS];
+                        for (int w = 0; w < WORDS; ++w) nx[w] |= vu[w] & ~sv[w];
+                    }
+                }
+                for (int v = 0; v < n; ++v) {
+                    uint64_t* nx = &next[(size_t)v * WORDS]; uint64_t* sv = &seen[(size_t)v * WORDS]; uint64_t any = 0;
+                    for (int w = 0; w < WORDS; ++w) { nx[w] &= ~sv[w]; sv[w] |= nx[w]; any |= nx[w]; }
+                    if (any) { onVisit(level, v, first, nx); active = true; }
+                }
+                if (!active) break;
+                swap(visit, next);
+                fill(next.begin(), next.end(), 0);
+            }
+        }
+
+        // Per-source distances as one flat k x n matrix (-1 = unreachable); batches of 64 * WORDS
+        // sources run on separate threads.
+        struct DistanceMatrix {
+            int k = 0, n = 0; vector<int> d;
+            int operator()(int i, int v) const { return d[(size_t)i * n + v]; }
+            const int* row(int i) const { return d.data() + (size_t)i * n; }
+        };
+        template<int WORDS = 1> DistanceMatrix multiSourceDistances(const vector<int>& sources, int threads = 1) const {
+            DistanceMatrix D; D.k = (int)sources.size(); D.n = n; D.d.assign((size_t)D.k * n, -1);
+            const int B = 64 * WORDS, batches = (D.k + B - 1) / B;
+            atomic<int> nextBatch{0};
+            runThreads(max(1, min(threads, batches)), [&](int) {
+                vector<uint64_t> seen, visit, next;
+                auto record = [&](int level, int v, int first, const uint64_t* mask) {
+                    for (int w = 0; w < WORDS; ++w) for (uint64_t b = mask[w]; b; b &= b - 1)
+                            D.d[(size_t)(first + 64 * w + __builtin_ctzll(b)) * n + v] = level;
+                };
+                for (int b; (b = nextBatch++) < batches; )
+                    msbfsBatch<WORDS>(sources.data() + b * B, min(B, D.k - b * B), b * B, record, seen, visit, next);
+            });
+            return D;
+        }
+
+        // ---------- Point-to-point queries (bidirectional) ----------
+        // Search from s forward and from t backward (over reverse()) until the two balls prove
+        // the best meeting point, keeping state in hash maps so the cost follows the explored
+        // vertices instead of n. Return {distance, path s..t}; unreachable gives {-1, {}} for
+        // the BFS version and {INF = max/4, {}} for the Dijkstra version (negative arcs skipped).
+        pair<int, vector<int>> shortestPathUnweighted(int s, int t) const {
+            if (s < 0 || s >= n || t < 0 || t >= n) return {-1, {}};
+            if (s == t) return {0, {s}};
+            CSR in = reverse();
+            unordered_map<int, pair<int, int>> side[2];  // vertex -> (dist, parent) per direction
+            vector<int> front[2] = {{s}, {t}};
+            side[0][s] = {0, -1}; side[1][t] = {0, -1};
+            while (!front[0].empty() && !front[1].empty()) {
+                int x = front[0].size() <= front[1].size() ? 0 : 1;  // grow the smaller frontier by one level
+                const CSR& g = x == 0 ? *this : in;
+                int best = INT_MAX, meet = -1; vector<int> nxt;
+                for (int u : front[x]) {
+                    int du = side[x][u].first;
+                    for (ll k = g.off[u]; k < g.off[u + 1]; ++k) {
+                        int v = g.to[k];
+                        if (!side[x].emplace(v, make_pair(du + 1, u)).second) continue;
+                        nxt.push_back(v);
+                        auto it = side[1 - x].find(v);
+                        if (it != side[1 - x].end() && du + 1 + it->second.first < best) { best = du + 1 + it->second.first; meet = v; }
+                    }
+                }
+                if (meet != -1) return {best, joinPath(meet, [&](int d, int v) { return side[d][v].second; })};
+                front[x].swap(nxt);
+            }
+            return {-1, {}};
+        }
+        pair<W, vector<int>> shortestPath(int s, int t) const {
+            const W INF = numeric_limits<W>::max() / 4;
+            if (s < 0 || s >= n || t < 0 || t >= n) return {INF, {}};
+            CSR in = reverse();
+            using P = pair<W, int>;
+            unordered_map<int, pair<W, int>> side[2];
+            priority_queue<P, vector<P>, greater<P>> pq[2];
+            side[0][s] = {0, -1}; side[1][t] = {0, -1};
+            pq[0].push({0, s}); pq[1].push({0, t});
+            W mu = s == t ? 0 : INF; int meet = s == t ? s : -1;
+            while (!pq[0].empty() && !pq[1].empty()) {
+                if (pq[0].top().first + pq[1].top().first >= mu) break;  // no shorter s-t path left
+                int x = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+                auto [d, u] = pq[x].top(); pq[x].pop();
+                if (d != side[x][u].first) continue;
+                const CSR& g = x == 0 ? *this : in;
+                for (ll k = g.off[u]; k < g.off[u + 1]; ++k) {
+                    int v = g.to[k]; W w = g.wt[k];
+                    if (w < 0) continue; // negative weights not supported
+                    auto it = side[x].find(v);
+                    if (it == side[x].end()) it = side[x].emplace(v, make_pair(INF, -1)).first;
+                    if (it->second.first > d + w) { it->second = {d + w, u}; pq[x].push({d + w, v}); }
+                    auto ot = side[1 - x].find(v);
+                    if (ot != side[1 - x].end() && d + w + ot->second.first < mu) { mu = d + w + ot->second.first; meet = v; }
+                }
+            }
+            if (meet == -1) return {INF, {}};
+            return {mu, joinPath(meet, [&](int d, int v) { return side[d][v].second; })};
+        }
+        // s..meet from the forward parents, then meet..t from the backward ones
+        template<class Par> static vector<int> joinPath(int meet, Par par) {
+            vector<int> path;
+            for (int v = meet; v != -1; v = par(0, v)) path.push_back(v);
+            std::reverse(path.begin(), path.end());  // CSR::reverse hides the algorithm
+            for (int v = par(1, meet); v != -1; v = par(1, v)) path.push_back(v);
+            return path;
+        }
+
+        // ---------- Parallel SCC (trim + forward-backward + coloring) ----------
+        // Returns comp[v], components numbered 0.. in order of their smallest vertex.
+        //  1. trim: vertices with no live in-arc or no live out-arc are singleton SCCs (a few passes)
+        //  2. forward-backward: the SCC of a high-degree pivot = forward reach ∩ backward reach,
+        //     found with parallel level-synchronous searches; this takes out the giant component
+        //  3. coloring: every live vertex starts with its own id as color and the maximum color is
+        //     propagated along arcs until stable; each vertex r with color r then owns the SCC of
+        //     the vertices with color r that reach it backward. Repeat on what is left.
+        vector<int> parallelSCC(int threads = hardwareThreads()) const {
+            int T = max(1, threads);
+            CSR in = reverse();
+            vector<int> comp(n, -1), color(n);
+            vector<char> live(n, 1);
+            atomic<int> ids{0};
+            auto alive = [&](int v) { return __atomic_load_n(&live[v], __ATOMIC_RELAXED) != 0; };
+            auto hasLive = [&](const CSR& g, int v) {
+                for (ll k = g.off[v]; k < g.off[v + 1]; ++k) if (g.to[k] != v && alive(g.to[k])) return true;
+                return false;
+            };
+            auto trim = [&] {
+                for (int pass = 0; pass < 3; ++pass) {
+                    atomic<ll> removed{0};
+                    parallelFor(T, n, [&](ll v, int) {
+                        if (!alive((int)v) || (hasLive(*this, (int)v) && hasLive(in, (int)v))) return;
+                        comp[v] = ids++; __atomic_store_n(&live[v], 0, __ATOMIC_RELAXED); removed++;
+                    });
+                    if (!removed) break;
+                }
+            };
+            // parallel level-synchronous search over live vertices, claiming `mark`
+            auto reach = [&](const CSR& g, int src, vector<char>& mark) {
+                vector<int> frontier{src}; vector<vector<int>> local(T);
+                mark[src] = 1;
+                while (!frontier.empty()) {
+                    parallelFor(T, (ll)frontier.size(), [&](ll i, int t) {
+                        int u = frontier[i];
+                        for (ll k = g.off[u]; k < g.off[u + 1]; ++k) {
+                            int v = g.to[k];
+                            if (alive(v) && !__atomic_load_n(&mark[v], __ATOMIC_RELAXED) && !__atomic_exchange_n(&mark[v], 1, __ATOMIC_RELAXED)) local[t].push_back(v);
+                        }
+                    }, 64);
+                    frontier.clear();
+                    for (auto &l : local) { frontier.insert(frontier.end(), l.begin(), l.end()); l.clear(); }
+                }
+            };
+
+            trim();
+            int pivot = -1; ll best = -1;
+            for (int v = 0; v < n; ++v) if (live[v]) { ll sc = (ll)degree(v) * in.degree(v); if (sc > best) { best = sc; pivot = v; } }
+            if (pivot != -1) {
+                vector<char> fw(n, 0), bw(n, 0);
+                reach(*this, pivot, fw); reach(in, pivot, bw);
+                int id = ids++;
+                parallelFor(T, n, [&](ll v, int) { if (fw[v] && bw[v]) { comp[v] = id; live[v] = 0; } });
+                trim();
+            }
+            while (true) {
+                vector<int> rest;
+                for (int v = 0; v < n; ++v) if (live[v]) { rest.push_back(v); color[v] = v; }
+                if (rest.empty()) break;
+                for (bool changed = true; changed; ) {
+                    atomic<bool> any{false};
+                    parallelFor(T, (ll)rest.size(), [&](ll i, int) {
+                        int u = rest[i], cu = __atomic_load_n(&color[u], __ATOMIC_RELAXED);
+                        for (ll k = off[u]; k < off[u + 1]; ++k) {
+                            int v = to[k]; if (!live[v]) continue;
+                            int cv = __atomic_load_n(&color[v], __ATOMIC_RELAXED);
+                            while (cu > cv && !__atomic_compare_exchange_n(&color[v], &cv, cu, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+                            if (cu > cv) any = true;
+                        }
+                    });
+                    changed = any;
+                }
+                // each root collects its color class backward; classes are disjoint, so roots run in parallel
+                vector<int> roots;
+                for (int v : rest) if (color[v] == v) roots.push_back(v);
+                parallelFor(T, (ll)roots.size(), [&](ll i, int) {
+                    int r = roots[i], id = ids++;
+                    vector<int> stk{r}; comp[r] = id;
+                    while (!stk.empty()) {
+                        int u = stk.back(); stk.pop_back();
+                        for (ll k = in.off[u]; k < in.off[u + 1]; ++k) {
+                            int v = in.to[k];
+                            if (live[v] && color[v] == r && comp[v] == -1) { comp[v] = id; stk.push_back(v); }
+                        }
+                    }
+                }, 1);
+                for (int v : rest) if (comp[v] != -1) live[v] = 0;
+            }
+            // renumber by smallest vertex so the labels do not depend on scheduling
+            vector<int> label(ids.load(), -1); int k = 0;
+            for (int v = 0; v < n; ++v) { int &l = label[comp[v]]; if (l == -1) l = k++; comp[v] = l; }
+            return comp;
+        }
+
+        // ---------- ALT preprocessing ----------
+        // Farthest selection: the first landmark is the vertex farthest from 0, each next one
+        // maximizes the distance to the nearest landmark chosen so far (vertices no landmark
+        // reaches come first, so every component gets one). Forward tables come out of the
+        // selection; the backward ones (Dijkstra over reverse()) run in parallel afterwards.
+        Landmarks landmarks(int k, int threads = hardwareThreads()) const {
+            const W INF = numeric_limits<W>::max() / 4;
+            Landmarks L; L.n = n; L.k = k = max(0, min(k, n));
+            L.fwd.assign((ll)n * k, INF); L.bwd.assign((ll)n * k, INF);
+            if (k == 0) return L;
+            vector<W> nearest = dijkstraIndexedOn<4>(*this, 0).first;
+            for (W &x : nearest) x = x >= INF ? -1 : x;  // first pick: farthest from 0, nothing is uncovered yet
+            for (int i = 0; i < k; ++i) {
+                int far = (int)(max_element(nearest.begin(), nearest.end()) - nearest.begin());
+                L.ids.push_back(far);
+                vector<W> d = dijkstraIndexedOn<4>(*this, far).first;
+                if (i == 0) fill(nearest.begin(), nearest.end(), INF);
+                for (int v = 0; v < n; ++v) { L.fwd[(ll)v * k + i] = d[v]; nearest[v] = min(nearest[v], d[v]); }
+                for (int x : L.ids) nearest[x] = -1;
+            }
+            CSR in = reverse();
+            parallelFor(threads, k, [&](ll i, int) {
+                vector<W> d = dijkstraIndexedOn<4>(in, L.ids[i]).first;
+                for (int v = 0; v < n; ++v) L.bwd[(ll)v * k + i] = d[v];
+            }, 1);
+            return L;
+        }
+
+        // ---------- Delta-stepping SSSP (parallel) ----------
+        // Buckets of width delta are settled in increasing order. Inside the current bucket the
+        // light arcs (w <= delta) are relaxed in rounds until the bucket stays empty, then the
+        // heavy arcs of everything settled there are relaxed once. Every vertex is owned by
+        // thread v % threads, which alone writes its dist / parent / bucket entry; the other
+        // threads send it relaxation requests through per-pair outboxes, so no atomics are
+        // needed and dist / parent stay consistent. Same distances as dijkstra(), parent is a
+        // shortest-path tree; negative arcs are skipped like there. delta <= 0 picks
+        // max weight / average degree.
+        pair<vector<W>, vector<int>> deltaStepping(int src, W delta = 0, int threads = hardwareThreads()) const {
+            const W INF = numeric_limits<W>::max() / 4;
+            vector<W> dist(n, INF), expanded(n, INF);  // expanded[v]: dist[v] when v last relaxed its arcs
+            vector<int> parent(n, -1);
+            if (src < 0 || src >= n) return {dist, parent};
+            if (!(delta > 0)) {
+                W mx = 0; for (ll k = 0; k < m; ++k) mx = max(mx, wt[k]);
+                delta = mx / (W)max<ll>(1, m / max(n, 1));
+                if (!(delta > 0)) delta = 1;
+            }
+            int T = max(1, threads);
+            struct Req { int v, u; W d; };
+            vector<vector<vector<Req>>> out(T, vector<vector<Req>>(T));  // out[from][owner]
+            vector<map<ll, vector<int>>> buckets(T);
+            auto bucketOf = [&](W d) { return (ll)(d / delta); };
+            dist[src] = 0; buckets[src % T][0].push_back(src);
+            vector<ll> localMin(T); vector<char> more(T);
+            ll cur = 0; bool again = false;
+            Barrier bar(T);
+            runThreads(T, [&](int t) {
+                vector<int> settled, F;
+                auto request = [&](int u, bool heavy) {
+                    for (ll k = off[u]; k < off[u + 1]; ++k) {
+                        W w = wt[k];
+                        if (w < 0 || (w > delta) != heavy) continue; // negative weights not supported
+                        out[t][to[k] % T].push_back({to[k], u, dist[u] + w});
+                    }
+                };
+                auto apply = [&] {
+                    for (int s = 0; s < T; ++s) {
+                        for (auto &r : out[s][t]) if (r.d < dist[r.v]) { dist[r.v] = r.d; parent[r.v] = r.u; buckets[t][bucketOf(r.d)].push_back(r.v); }
+                        out[s][t].clear();
+                    }
+                };
+                while (true) {
+                    localMin[t] = buckets[t].empty() ? LLONG_MAX : buckets[t].begin()->first;
+                    bar.wait();
+                    if (t == 0) cur = *min_element(localMin.begin(), localMin.end());
+                    bar.wait();
+                    if (cur == LLONG_MAX) break;
+                    settled.clear();
+                    do { // light rounds
+                        F.clear();
+                        auto it = buckets[t].find(cur);
+                        if (it != buckets[t].end()) { F.swap(it->second); buckets[t].erase(it); }
+                        for (int v : F) {
+                            if (bucketOf(dist[v]) != cur || expanded[v] == dist[v]) continue; // stale entry or duplicate
+                            expanded[v] = dist[v]; settled.push_back(v);
+                            request(v, false);
+                        }
+                        bar.wait();
+                        apply();
+                        more[t] = buckets[t].count(cur) > 0;
+                        bar.wait();
+                        if (t == 0) again = count(more.begin(), more.end(), 1) > 0;
+                        bar.wait();
+                    } while (again);
+                    sort(settled.begin(), settled.end());
+                    settled.erase(unique(settled.begin(), settled.end()), settled.end());
+                    for (int v : settled) request(v, true);
+                    bar.wait();
+                    apply();
+                }
+            });
+            return {dist, parent};
+        }
+
+        // same queries as Graph, running directly on the CSR arrays
+        vector<int> breadthFirstSearch(int src) const { return bfsOn(*this, src); }
+        vector<int> multiSourceBFS(const vector<int>& sources) const { return multiSourceBFSOn(*this, sources); }
+        vector<int> depthFirstSearchRecursive(int src) const { return dfsRecursiveOn(*this, src); }
+        vector<int> depthFirstSearchIterative(int src) const { return dfsIterativeOn(*this, src); }
+        vector<int> topologicalSortKahn() const { return topoKahnOn(*this); }
+        vector<int> topologicalSortDFS() const { return topoDFSOn(*this); }
+        pair<vector<W>, vector<int>> dijkstra(int src, SSSPQueue queue = SSSPQueue::LazyBinary) const { return dijkstraOn(*this, src, queue); }
+        template<int D> pair<vector<W>, vector<int>> dijkstraIndexed(int src) const { return dijkstraIndexedOn<D>(*this, src); }
+        template<class H> pair<W, vector<int>> astar(int s, int t, H h) const { Workspace ws; return astarOn(*this, s, t, h, ws); }
+        template<class H> pair<W, vector<int>> astar(int s, int t, H h, Workspace& ws) const { return astarOn(*this, s, t, h, ws); }
+        vector<W> zeroOneBFS(int src, W INF_VAL = (W)4e18) const { return zeroOneBFSOn(*this, src, INF_VAL); }
+        void breadthFirstSearch(int src, Workspace& ws) const { bfsOn(*this, src, ws); }
+        void depthFirstSearchIterative(int src, Workspace& ws) const { dfsIterativeOn(*this, src, ws); }
+        void dijkstra(int src, Workspace& ws) const { dijkstraOn(*this, src, ws); }
+        void zeroOneBFS(int src, Workspace& ws) const { zeroOneBFSOn(*this, src, ws); }
+        bool bellmanFord(int src, Workspace& ws) const { return bellmanFordOn(*this, src, ws); }
+        pair<vector<int>, vector<Edge>> negativeCycle(int src = -1) const { return negativeCycleOn(*this, src); }
+        template<class F> void search(int src, SearchKind kind, Workspace& ws, F visit) const { searchOn(*this, src, kind, ws, visit); }
+        vector<pair<int, W>> ball(int src, W radius, Workspace& ws, SearchKind kind = SearchKind::Dijkstra) const { return ballOn(*this, src, radius, ws, kind); }
+        template<class P> vector<pair<int, W>> nearest(int src, int k, P pred, Workspace& ws, SearchKind kind = SearchKind::Dijkstra) const { return nearestOn(*this, src, k, pred, ws, kind); }
+        vector<pair<int, W>> distancesTo(int src, const vector<int>& targets, Workspace& ws, SearchKind kind = SearchKind::Dijkstra) const { return distancesToOn(*this, src, targets, ws, kind); }
+        tuple<vector<W>, bool, vector<int>> bellmanFord(int src) const { return bellmanFordOn(n, directed ? arcs() : edgesForMST(), src); }
+        vector<W> shortestPathOnDAG(int src, W INF_VAL = numeric_limits<W>::max() / 4) const { return shortestPathOnDAGOn(*this, src, INF_VAL); }
+        vector<Edge> edgesForMST() const { return edgesForMSTOn(*this); }
+        pair<W, vector<Edge>> kruskalMST() const { if (directed) return {0, {}}; return kruskalOn(n, edgesForMST()); }
+        pair<W, vector<int>> primMST(int src = 0) const { return primOn(*this, src); }
+        vector<vector<int>> kosarajuSCC() const { return kosarajuOn(*this); }
+        vector<vector<int>> tarjanSCC() const { return tarjanOn(*this); }
+        pair<vector<pair<int, int>>, vector<int>> findBridgesAndArticulationPoints() const { return bridgesOn(*this); }
+        Components stronglyConnectedComponents() const { return Components::fromLabels(sccLabelsOn(*this)); }
+        CSR condensation(const Components& c) const { return condensationOn(*this, c); }
+    };
+
+    // ---------- Freeze (Graph -> CSR) ----------
+    // Row order is preserved, so every query returns exactly what the Graph version does.
+    CSR freeze() const {
+        auto a = make_shared<typename CSR::Arrays>();
+        a->off.assign(n + 1, 0);
+        for (int u = 0; u < n; ++u) a->off[u + 1] = a->off[u] + (ll)adj[u].size();
+        a->to.resize(a->off[n]); a->wt.resize(a->off[n]);
+        for (int u = 0; u < n; ++u) {
+            ll k = a->off[u];
+            for (auto &pr : adj[u]) { a->to[k] = pr.first; a->wt[k] = pr.second; ++k; }
+        }
+        // edge ids: replay `edges` in insertion order, which is the order addEdge filled adj
+        if (any_of(edges.begin(), edges.end(), [](const Edge & e) { return e.id != -1; })) {
+            a->eid.assign(a->off[n], -1);
+            vector<ll> cur(a->off.begin(), a->off.end() - 1);
+            auto place = [&](int u, int v, int id) {
+                if (cur[u] >= a->off[u + 1] || a->to[cur[u]] != v) return false;
+                a->eid[cur[u]++] = id; return true;
+            };
+            for (auto &e : edges)
+                if (!place(e.u, e.v, e.id) || (!directed && !place(e.v, e.u, e.id))) { a->eid.clear(); break; } // adj was edited by hand
+        }
+        return CSR::adopt(a, directed);
+    }
+
+    // ---------- Contraction hierarchies ----------
+    // Preprocessing contracts vertices in priority order (edge difference = shortcuts needed
+    // minus arcs removed, plus the number of already contracted neighbours, which spreads the
+    // contraction evenly). Priorities are updated lazily: a round takes a batch from the top of
+    // the queue, re-evaluates only those candidates (in parallel), then picks best first an
+    // independent set of them and contracts it in parallel; a candidate that got worse than
+    // the rest of the queue, or is adjacent to a picked vertex, is requeued. Contracting v adds
+    // u->w with weight w(u,v) + w(v,w) unless a witness search (Dijkstra from u avoiding the
+    // set, capped at witnessLimit settled vertices and hopLimit arcs) finds a path no longer,
+    // so the parallel contractions never rely on each other; a capped search just keeps the
+    // shortcut. Priorities only estimate the shortcut count with a search ten times shorter.
+    // The working rows hold the uncontracted graph only, sorted by target so shortcuts merge
+    // by binary search; a contracted vertex's remaining arcs, which all lead to later
+    // vertices, become its hierarchy arcs:
+    // `up` holds u->w with rank[u] < rank[w], `down` holds a->x with rank[a] > rank[x] stored in
+    // row x, and eid is the middle vertex of a shortcut (-1 for an input arc). A query runs
+    // Dijkstra upward from s on `up` and from t on `down` and meets at the best common vertex.
+    // Negative arcs are skipped like in dijkstra().
+    struct ContractionHierarchy {
+        int n = 0; vector<int> rank; CSR up, down;
+
+        static ContractionHierarchy build(const CSR& g, int threads = hardwareThreads(), int witnessLimit = 100, int hopLimit = 5) {
+            struct Arc { int to; W w; int mid; };
+            int n = g.n, T = max(1, threads);
+            // rows sorted by target, one arc per ordered pair (the lightest)
+            vector<vector<Arc>> out(n), in(n);
+            auto find = [](vector<Arc>& row, int to) { return lower_bound(row.begin(), row.end(), to, [](const Arc& a, int x) { return a.to < x; }); };
+            auto insert = [&](vector<Arc>& row, int to, W w, int mid) {
+                auto it = find(row, to);
+                if (it == row.end() || it->to != to) row.insert(it, {to, w, mid});
+                else if (w < it->w) it->w = w, it->mid = mid;
+            };
+            auto drop = [&](vector<Arc>& row, int x) { auto it = find(row, x); if (it != row.end() && it->to == x) row.erase(it); };
+            for (int u = 0; u < n; ++u) for (ll k = g.off[u]; k < g.off[u + 1]; ++k)
+                    if (g.to[k] != u && g.wt[k] >= 0) { out[u].push_back({g.to[k], g.wt[k], -1}); in[g.to[k]].push_back({u, g.wt[k], -1}); }
+            for (auto* rows : {&out, &in}) for (auto &row : *rows) {
+                    sort(row.begin(), row.end(), [](const Arc& a, const Arc& b) { return a.to != b.to ? a.to < b.to : a.w < b.w; });
+                    row.erase(unique(row.begin(), row.end(), [](const Arc& a, const Arc& b) { return a.to == b.to; }), row.end());
+                }
+
+            vector<int> rank(n, -1), deleted(n, 0), prio(n);
+            vector<char> busy(n, 0), blocked(n, 0), dirty(n, 0);  // busy: in the set being contracted
+            vector<Workspace> wss(T); vector<vector<int>> hops(T, vector<int>(n));
+            // emit(u, w, weight) for every shortcut that removing v would need
+            auto shortcuts = [&](int v, int t, int limit, auto emit) {
+                Workspace& ws = wss[t]; vector<int>& hop = hops[t];
+                for (auto &a : in[v]) {
+                    int u = a.to;
+                    W maxD = 0;
+                    for (auto &b : out[v]) if (b.to != u) maxD = max(maxD, a.w + b.w);
+                    ws.begin(n);
+                    auto &h = ws.heap; auto later = greater<pair<W, int>>();
+                    ws.set(u, 0, -1); hop[u] = 0; h.push_back({0, u});
+                    for (int settled = 0; !h.empty() && settled < limit; ) {
+                        pop_heap(h.begin(), h.end(), later);
+                        auto [d, x] = h.back(); h.pop_back();
+                        if (d != ws.d[x]) continue;
+                        if (d > maxD) break;
+                        ++settled;
+                        if (hop[x] == hopLimit) continue;
+                        for (auto &b : out[x]) {
+                            int y = b.to;
+                            if (y == v || busy[y]) continue;
+                            if (!ws.seen(y) || ws.d[y] > d + b.w) { ws.set(y, d + b.w, x); hop[y] = hop[x] + 1; h.push_back({d + b.w, y}); push_heap(h.begin(), h.end(), later); }
+                        }
+                    }
+                    for (auto &b : out[v]) {
+                        int w = b.to;
+                        if (w == u) continue;
+                        if (!(ws.seen(w) && ws.d[w] <= a.w + b.w)) emit(u, w, a.w + b.w);
+                    }
+                }
+            };
+            auto priority = [&](int v, int t) {
+                int added = 0;
+                shortcuts(v, t, max(1, witnessLimit / 10), [&](int, int, W) { ++added; });
+                return added - (int)(out[v].size() + in[v].size()) + deleted[v];
+            };
+
+            parallelFor(T, n, [&](ll v, int t) { prio[v] = priority((int)v, t); }, 64);
+            priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+            for (int v = 0; v < n; ++v) pq.push({prio[v], v});
+            auto neighbours = [&](int v, auto f) { for (auto &a : out[v]) f(a.to); for (auto &a : in[v]) f(a.to); };
+            vector<vector<tuple<int, int, W, int>>> found(T);  // (u, w, weight, mid) per thread
+            vector<int> cand, chosen;
+            vector<Edge> upE, downE;
+            int next = 0;
+            while (!pq.empty()) {
+                // lazy update: only a batch from the top of the queue is re-evaluated, and only the
+                // candidates whose neighbourhood changed since their last evaluation
+                cand.clear();
+                size_t batch = max<size_t>(16 * T, pq.size() / 256);
+                while (!pq.empty() && cand.size() < batch) { cand.push_back(pq.top().second); pq.pop(); }
+                parallelFor(T, (ll)cand.size(), [&](ll i, int t) {
+                    int v = cand[i];
+                    if (dirty[v]) prio[v] = priority(v, t), dirty[v] = 0;
+                }, 4);
+                sort(cand.begin(), cand.end(), [&](int a, int b) { return make_pair(prio[a], a) < make_pair(prio[b], b); });
+                // best first, take an independent set; a candidate that got worse than the rest of
+                // the queue or touches a chosen vertex goes back
+                int bound = pq.empty() ? INT_MAX : pq.top().first;
+                chosen.clear();
+                for (int v : cand) {
+                    if (blocked[v] || (prio[v] > bound && !chosen.empty())) { pq.push({prio[v], v}); continue; }
+                    chosen.push_back(v); busy[v] = blocked[v] = 1;
+                    neighbours(v, [&](int x) { blocked[x] = 1; });
+                }
+                for (int v : chosen) { blocked[v] = 0; neighbours(v, [&](int x) { blocked[x] = 0; }); }
+                parallelFor(T, (ll)chosen.size(), [&](ll i, int t) {
+                    int v = chosen[i];
+                    shortcuts(v, t, witnessLimit, [&](int u, int w, W c) { found[t].push_back({u, w, c, v}); });
+                }, 1);
+                for (int v : chosen) {
+                    rank[v] = next++; busy[v] = 0;
+                    for (auto &a : out[v]) { upE.push_back({v, a.to, a.w, a.mid}); drop(in[a.to], v); deleted[a.to]++; dirty[a.to] = 1; }
+                    for (auto &a : in[v]) { downE.push_back({v, a.to, a.w, a.mid}); drop(out[a.to], v); deleted[a.to]++; dirty[a.to] = 1; }
+                    vector<Arc>().swap(out[v]); vector<Arc>().swap(in[v]);
+                }
+                for (auto &f : found) {
+                    for (auto [u, w, c, mid] : f) { insert(out[u], w, c, mid); insert(in[w], u, c, mid); dirty[u] = dirty[w] = 1; }
+                    f.clear();
+                }
+            }
+
+            ContractionHierarchy ch; ch.n = n; ch.rank = move(rank);
+            ch.up = CSR::buildFromEdgeList(n, true, upE, T);
+            ch.down = CSR::buildFromEdgeList(n, true, downE, T);
+            return ch;
+        }
+
+        // Bidirectional upward search; fw / bw are reused across queries, so a query costs only
+        // the (small) upward search spaces. Returns {distance, meeting vertex}, {INF, -1} if none.
+        pair<W, int> search(int s, int t, Workspace& fw, Workspace& bw) const {
+            const W INF = numeric_limits<W>::max() / 4;
+            fw.begin(n); bw.begin(n);
+            if (s < 0 || s >= n || t < 0 || t >= n) return {INF, -1};
+            Workspace* ws[2] = {&fw, &bw}; const CSR* g[2] = {&up, &down};
+            auto later = greater<pair<W, int>>();
+            fw.set(s, 0, -1); fw.heap.push_back({0, s});
+            bw.set(t, 0, -1); bw.heap.push_back({0, t});
+            W best = s == t ? 0 : INF; int meet = s == t ? s : -1;
+            while (true) {
+                int x = -1;
+                for (int i = 0; i < 2; ++i)
+                    if (!ws[i]->heap.empty() && ws[i]->heap.front().first < best && (x == -1 || ws[i]->heap.front().first < ws[x]->heap.front().first)) x = i;
+                if (x == -1) break;
+                auto &h = ws[x]->heap;
+                pop_heap(h.begin(), h.end(), later);
+                auto [d, u] = h.back(); h.pop_back();
+                if (d != ws[x]->d[u]) continue;
+                if (ws[1 - x]->seen(u) && d + ws[1 - x]->d[u] < best) { best = d + ws[1 - x]->d[u]; meet = u; }
+                // stall-on-demand: a higher vertex already reached gives u a shorter distance
+                // through an arc of the other direction, so u's upward arcs cannot be on a shortest path
+                const CSR& o = *g[1 - x]; bool stalled = false;
+                for (ll k = o.off[u]; k < o.off[u + 1] && !stalled; ++k) stalled = ws[x]->seen(o.to[k]) && ws[x]->d[o.to[k]] + o.wt[k] < d;
+                if (stalled) continue;
+                for (ll k = g[x]->off[u]; k < g[x]->off[u + 1]; ++k) {
+                    int v = g[x]->to[k]; W w = g[x]->wt[k];
+                    if (!ws[x]->seen(v) || ws[x]->d[v] > d + w) { ws[x]->set(v, d + w, u); h.push_back({d + w, v}); push_heap(h.begin(), h.end(), later); }
+                }
+            }
+            return {best, meet};
+        }
+        W distance(int s, int t, Workspace& fw, Workspace& bw) const { return search(s, t, fw, bw).first; }
+        pair<W, vector<int>> query(int s, int t) const { Workspace fw, bw; return query(s, t, fw, bw); }
+        // {distance, path s..t in input vertices}, {INF, {}} if unreachable
+        pair<W, vector<int>> query(int s, int t, Workspace& fw, Workspace& bw) const {
+            auto [d, meet] = search(s, t, fw, bw);
+            if (meet == -1) return {d, {}};
+            vector<int> hops;  // vertices along the hierarchy path
+            for (int v = meet; v != -1; v = fw.par[v]) hops.push_back(v);
+            std::reverse(hops.begin(), hops.end());
+            for (int v = bw.par[meet]; v != -1; v = bw.par[v]) hops.push_back(v);
+            vector<int> path{hops[0]};
+            for (size_t i = 0; i + 1 < hops.size(); ++i) unpack(hops[i], hops[i + 1], path);
+            return {d, path};
+        }
+        // middle vertex of the hierarchy arc a->b (-1 for an input arc)
+        int middle(int a, int b) const {
+            const CSR& g = rank[a] < rank[b] ? up : down;
+            int from = rank[a] < rank[b] ? a : b, to = rank[a] < rank[b] ? b : a;
+            for (ll k = g.off[from]; k < g.off[from + 1]; ++k) if (g.to[k] == to) return g.eid ? g.eid[k] : -1;
+            return -1;
+        }
+        // append the input vertices of arc a->b after a, expanding shortcuts (explicit stack)
+        void unpack(int a, int b, vector<int>& path) const {
+            vector<pair<int, int>> st{{a, b}};
+            while (!st.empty()) {
+                auto [x, y] = st.back(); st.pop_back();
+                int mid = middle(x, y);
+                if (mid == -1) path.push_back(y);
+                else { st.push_back({mid, y}); st.push_back({x, mid}); }
+            }
+        }
+    };
+    ContractionHierarchy contractionHierarchy(int threads = hardwareThreads()) const { return ContractionHierarchy::build(freeze(), threads); }
+
+    // ---------- Pruned landmark labeling (2-hop hub labels) ----------
+    // Exact distance oracle. Vertices are taken as hubs in decreasing degree order; a search
+    // from hub h (BFS when every weight is 1, Dijkstra otherwise) gives each vertex v it reaches
+    // the label entry (h, d) unless the labels built so far already prove a distance <= d, in
+    // which case v is neither labelled nor expanded. d(s, t) is the minimum of d(s, h) + d(h, t)
+    // over the hubs shared by the out-label of s and the in-label of t: one merge of two runs
+    // sorted by hub rank. Labels are kept as a CSR: row v is the out-label of v, row n + v its
+    // in-label (directed only, an undirected graph has one label per vertex), `to` = hub rank,
+    // `wt` = distance, so save() / load() are the CSR snapshot and loading is zero-copy.
+    // Negative arcs are skipped like in dijkstra().
+    struct HubLabels {
+        int n = 0; CSR L;
+
+        static HubLabels build(const CSR& g) {
+            const W INF = numeric_limits<W>::max() / 4;
+            int n = g.n; bool dir = g.directed;
+            CSR rev = g.reverse();
+            vector<int> order(n); iota(order.begin(), order.end(), 0);
+            auto deg = [&](int v) { return g.degree(v) + (dir ? rev.degree(v) : 0); };
+            stable_sort(order.begin(), order.end(), [&](int a, int b) { return deg(a) > deg(b); });
+            bool unit = all_of(g.wt, g.wt + g.m, [](W w) { return w == 1; });
+            vector<vector<pair<int, W>>> outL(n), inStore(dir ? n : 0);
+            auto &inL = dir ? inStore : outL;
+            vector<W> tmp(n, INF);  // d(h, x) (or d(x, h)) by hub rank x for the current hub
+            Workspace ws;
+            for (int r = 0; r < n; ++r) {
+                int h = order[r];
+                // side 0: forward from h fills in-labels, pruned by out(h) x in(v);
+                // side 1: backward to h fills out-labels, pruned by in(h) x out(v)
+                for (int side = 0; side < (dir ? 2 : 1); ++side) {
+                    const CSR& G = side == 0 ? g : rev;
+                    auto &mine = side == 0 ? outL[h] : inL[h];
+                    auto &fill = side == 0 ? inL : outL;
+                    for (auto [x, d] : mine) tmp[x] = d;
+                    auto keep = [&](int v, W d) {
+                        for (auto [x, dx] : fill[v]) if (tmp[x] + dx <= d) return false;
+                        fill[v].push_back({r, d});
+                        return true;
+                    };
+                    ws.begin(n); ws.set(h, 0, -1);
+                    if (unit) {
+                        ws.q.push_back(h);
+                        for (size_t i = 0; i < ws.q.size(); ++i) {
+                            int u = ws.q[i]; W d = ws.d[u];
+                            if (!keep(u, d)) continue;
+                            for (ll k = G.off[u]; k < G.off[u + 1]; ++k)
+                                if (!ws.seen(G.to[k])) { ws.set(G.to[k], d + 1, u); ws.q.push_back(G.to[k]); }
+                        }
+                    } else {
+                        auto &pq = ws.heap; auto later = greater<pair<W, int>>();
+                        pq.push_back({0, h});
+                        while (!pq.empty()) {
+                            pop_heap(pq.begin(), pq.end(), later);
+                            auto [d, u] = pq.back(); pq.pop_back();
+                            if (d != ws.d[u] || !keep(u, d)) continue;
+                            for (ll k = G.off[u]; k < G.off[u + 1]; ++k) {
+                                int v = G.to[k]; W w = G.wt[k];
+                                if (w < 0) continue; // negative weights not supported
+                                if (!ws.seen(v) || ws.d[v] > d + w) { ws.set(v, d + w, u); pq.push_back({d + w, v}); push_heap(pq.begin(), pq.end(), later); }
+                            }
+                        }
+                    }
+                    for (auto [x, d] : mine) tmp[x] = INF;
+                }
+            }
+            auto a = make_shared<typename CSR::Arrays>();
+            a->off.assign(1, 0);
+            for (auto *side : {&outL, &inStore}) for (auto &lab : *side) {
+                    a->off.push_back(a->off.back() + (ll)lab.size());
+                    for (auto [x, d] : lab) { a->to.push_back(x); a->wt.push_back(d); }
+                    vector<pair<int, W>>().swap(lab);
+                }
+            HubLabels hl; hl.n = n; hl.L = CSR::adopt(a, dir);
+            return hl;
+        }
+        // INF = max/4 if t is unreachable from s
+        W distance(int s, int t) const {
+            W best = numeric_limits<W>::max() / 4;
+            if (s < 0 || s >= n || t < 0 || t >= n) return best;
+            int b = L.directed ? n + t : t;
+            ll i = L.off[s], ie = L.off[s + 1], j = L.off[b], je = L.off[b + 1];
+            while (i < ie && j < je) {
+                if (L.to[i] < L.to[j]) ++i;
+                else if (L.to[i] > L.to[j]) ++j;
+                else best = min(best, L.wt[i++] + L.wt[j++]);
+            }
+            return best;
+        }
+        ll entries() const { return L.m; }  // total label size
+        void save(const string& path) const { L.save(path); }
+        static HubLabels load(const string& path) {
+            HubLabels hl; hl.L = CSR::load(path);
+            hl.n = hl.L.directed ? hl.L.n / 2 : hl.L.n;
+            return hl;
+        }
+    };
+    HubLabels hubLabels() const { return HubLabels::build(freeze()); }
+
+    // ---------- Parallel text loader ----------
+    // Reads a graph file straight into a CSR. The file is mmapped and cut at line boundaries
+    // into one chunk per thread; every thread scans its lines with the hand-written number
+    // parser below into its own edge block, and the blocks go to CSR::buildFromEdgeBlocks
+    // without being merged. Vertex ids come out 0-indexed.
+    //   EdgeList      SNAP style "u v [w]", 0-indexed, '#' / '%' comments; `directed` as given
+    //   DIMACS        "p sp n m" and "a u v w" lines (1-indexed), 'c' comments; `directed` as given
+    //   METIS         header "n m [fmt [ncon]]", then line i lists the neighbors of vertex i; undirected
+    //   MatrixMarket  "%%MatrixMarket matrix coordinate ..." banner, "rows cols nnz", "i j [v]";
+    //                 general => directed, symmetric / hermitian => undirected
+    struct TextLoader {
+        enum Format { EdgeList, DIMACS, METIS, MatrixMarket };
+        using Chunk = pair<const char*, const char*>;
+
+        static Format guessFormat(const string& path) {
+            auto ends = [&](const string & ext) { return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0; };
+            if (ends(".gr")) return DIMACS;
+            if (ends(".graph") || ends(".metis")) return METIS;
+            if (ends(".mtx")) return MatrixMarket;
+            return EdgeList;
+        }
+        static CSR load(const string& path, bool directed = true, int threads = hardwareThreads()) {
+            return load(path, guessFormat(path), directed, threads);
+        }
+
+        // ----- scanning helpers (never read past e) -----
+        static const char* nextLine(const char* p, const char* e) { p = (const char*)memchr(p, '\n', e - p); return p ? p + 1 : e; }
+        static void skipBlanks(const char*& p, const char* e) { while (p < e && (*p == ' ' || *p == '\t' || *p == '\r')) ++p; }
+        static bool digit(char c) { return c >= '0' && c <= '9'; }
+        static bool readInt(const char*& p, const char* e, ll& x) {
+            skipBlanks(p, e);
+            const char* s = p; bool neg = false;
+            if (p < e && (*p == '-' || *p == '+')) neg = *p++ == '-';
+            if (p >= e || !digit(*p)) { p = s; return false; }
+            x = 0; while (p < e && digit(*p)) x = x * 10 + (*p++ - '0');
+            if (neg) x = -x;
+            return true;
+        }
+        // integer, or decimal / scientific notation (Matrix Market real values)
+        static bool readWeight(const char*& p, const char* e, W& w) {
+            skipBlanks(p, e);
+            const char* s = p; bool neg = false, any = false;
+            if (p < e && (*p == '-' || *p == '+')) neg = *p++ == '-';
+            ll ip = 0; while (p < e && digit(*p)) { ip = ip * 10 + (*p++ - '0'); any = true; }
+            if (p < e && (*p == '.' || *p == 'e' || *p == 'E')) {
+                double x = (double)ip;
+                if (*p == '.') {
+                    ++p; ll frac = 0; int digits = 0;
+                    while (p < e && digit(*p)) { if (digits < 18) { frac = frac * 10 + (*p - '0'); ++digits; } ++p; any = true; }
+                    x += frac / pow(10.0, digits);
+                }
+                if (any && p < e && (*p == 'e' || *p == 'E')) { ++p; ll ex; if (readInt(p, e, ex)) x *= pow(10.0, (double)ex); }
+                if (!any) { p = s; return false; }
+                w = (W)(neg ? -x : x); return true;
+            }
+            if (!any) { p = s; return false; }
+            w = (W)(neg ? -ip : ip); return true;
+        }
+        // cut [b, e) into `parts` ranges that each start at the beginning of a line
+        static vector<Chunk> splitLines(const char* b, const char* e, int parts) {
+            vector<Chunk> out; const char* s = b;
+            for (int i = 1; i <= parts && s < e; ++i) {
+                const char* t = i == parts ? e : max(s, nextLine(b + (e - b) * i / parts - 1, e));
+                if (t > s) out.push_back({s, t});
+                s = t;
+            }
+            if (out.empty()) out.push_back({b, b});
+            return out;
+        }
+
+        static CSR load(const string& path, Format fmt, bool directed, int threads) {
+            MappedFile f = MappedFile::open(path);
+            const char* b = f.data; const char* e = f.data + f.size;
+            auto starts = [&](const char* p, const char* word) { size_t k = strlen(word); return (size_t)(e - p) >= k && memcmp(p, word, k) == 0; };
+            ll n = 0; int base = 1; bool arcsGiven = false; // arcsGiven: each stored arc listed explicitly (METIS)
+            int edgeW = 0, vertexW = 0, vsize = 0, ncon = 0;
+            bool pattern = false;
+            // headers are read serially, the body is split across threads
+            if (fmt == METIS || fmt == MatrixMarket) {
+                if (fmt == MatrixMarket) {
+                    if (!starts(b, "%%MatrixMarket")) throw runtime_error("missing MatrixMarket banner: " + path);
+                    string banner(b, nextLine(b, e));
+                    for (auto &c : banner) c = (char)tolower(c);
+                    if (banner.find("coordinate") == string::npos) throw runtime_error("only coordinate MatrixMarket files are supported: " + path);
+                    pattern = banner.find("pattern") != string::npos;
+                    directed = banner.find("general") != string::npos;
+                }
+                while (b < e && (*b == '%' || *b == '\n' || *b == '\r')) b = nextLine(b, e);
+                const char* p = b; ll a = 0, c = 0, fmtCode = 0;
+                if (!readInt(p, e, a) || !readInt(p, e, c)) throw runtime_error("bad header in " + path);
+                if (fmt == MatrixMarket) n = max(a, c);
+                else {
+                    n = a; directed = false; arcsGiven = true;
+                    if (readInt(p, e, fmtCode)) { edgeW = fmtCode % 10; vertexW = fmtCode / 10 % 10; vsize = fmtCode / 100 % 10; }
+                    ll k; ncon = vertexW ? (readInt(p, e, k) ? (int)k : 1) : 0;
+                }
+                b = nextLine(b, e);
+            }
+            if (fmt == EdgeList) base = 0;
+
+            auto chunks = splitLines(b, e, max(1, threads));
+            int T = (int)chunks.size();
+            vector<ll> firstVertex(T, 0);
+            if (fmt == METIS) { // line i is vertex i, so every chunk needs the count of vertex lines before it
+                runThreads(T, [&](int t) { ll c = 0; for (const char* p = chunks[t].first; p < chunks[t].second; p = nextLine(p, e)) if (*p != '%') ++c; firstVertex[t] = c; });
+                ll s = 0; for (auto &c : firstVertex) { ll x = c; c = s; s += x; }
+            }
+
+            vector<vector<Edge>> out(T); vector<ll> maxId(T, -1), declared(T, 0);
+            runThreads(T, [&](int t) {
+                auto &E = out[t]; ll u, v; W w;
+                ll vertex = firstVertex[t];
+                for (const char* p = chunks[t].first; p < chunks[t].second; p = nextLine(p, e)) {
+                    const char* q = p; skipBlanks(q, e);
+                    char c = q < e ? *q : '\n';
+                    if (fmt == METIS) {
+                        if (*p == '%') continue;
+                        ll skip; for (int i = 0; i < vsize + ncon; ++i) readInt(q, e, skip);
+                        while (readInt(q, e, v)) {
+                            w = (W)1; if (edgeW && !readWeight(q, e, w)) break;
+                            E.emplace_back((int)vertex, (int)(v - 1), w);
+                        }
+                        ++vertex; continue;
+                    }
+                    if (fmt == DIMACS) {
+                        if (c == 'p') { ++q; while (q < e && *q != '\n' && !digit(*q)) ++q; if (readInt(q, e, u)) declared[t] = u; continue; }
+                        if (c != 'a') continue;
+                        ++q;
+                    } else if (c == '#' || c == '%' || c == '\n' || c == '\r') continue;
+                    if (!readInt(q, e, u) || !readInt(q, e, v)) continue;
+                    w = (W)1; if (!pattern) readWeight(q, e, w);
+                    u -= base; v -= base;
+                    maxId[t] = max(maxId[t], max(u, v));
+                    E.emplace_back((int)u, (int)v, w);
+                }
+            });
+            for (int t = 0; t < T; ++t) n = max(n, max(maxId[t] + 1, declared[t]));
+            if (n > INT_MAX) throw runtime_error("too many vertices in " + path);
+            vector<pair<const Edge*, const Edge*>> blocks;
+            for (auto &E : out) blocks.push_back({E.data(), E.data() + E.size()});
+            CSR g = CSR::buildFromEdgeBlocks((int)n, directed || arcsGiven, blocks);
+            g.directed = directed;
+            return g;
+        }
+    };
+
     // ---------- Utility: reconstruct path from parent array ----------
     static vector<int> reconstructPath(const vector<int>& parent, int target) {
         vector<int> path;
@@ -44,31 +1327,49 @@ struct Graph {
         return path;
     }
 
+    // The algorithms below are written once against any adjacency `g` with g.size() and
+    // g[u] iterable as (to, weight) pairs, i.e. both `adj` and a frozen CSR. The overloads
+    // taking a Workspace leave their results in it (ws.dist / ws.parent / ws.touched).
+
     // ---------- BFS (unweighted shortest path) ----------
     // returns vector<int> distances ( -1 == unreachable )
-    vector<int> breadthFirstSearch(int src) const {
+    vector<int> breadthFirstSearch(int src) const { return bfsOn(adj, src); }
+    template<class G> static vector<int> bfsOn(const G& g, int src) {
+        int n = (int)g.size();
         vector<int> dist(n, -1);
         if (src < 0 || src >= n) return dist;
         queue<int> q;
         dist[src] = 0; q.push(src);
         while (!q.empty()) {
             int u = q.front(); q.pop();
-            for (auto &pr : adj[u]) {
+            for (auto pr : g[u]) {
                 int v = pr.first;
                 if (dist[v] == -1) { dist[v] = dist[u] + 1; q.push(v); }
             }
         }
         return dist;
     }
+    void breadthFirstSearch(int src, Workspace& ws) const { bfsOn(adj, src, ws); }
+    template<class G> static void bfsOn(const G& g, int src, Workspace& ws) {
+        ws.begin((int)g.size());
+        if (src < 0 || src >= (int)g.size()) return;
+        ws.set(src, 0, -1); ws.q.push_back(src);
+        for (size_t h = 0; h < ws.q.size(); ++h) {
+            int u = ws.q[h];
+            for (auto pr : g[u]) if (!ws.seen(pr.first)) { ws.set(pr.first, ws.d[u] + 1, u); ws.q.push_back(pr.first); }
+        }
+    }
 
     // ---------- Multi-source BFS ----------
-    vector<int> multiSourceBFS(const vector<int>& sources) const {
+    vector<int> multiSourceBFS(const vector<int>& sources) const { return multiSourceBFSOn(adj, sources); }
+    template<class G> static vector<int> multiSourceBFSOn(const G& g, const vector<int>& sources) {
+        int n = (int)g.size();
         vector<int> dist(n, -1);
         queue<int> q;
         for (int s : sources) if (s >= 0 && s < n && dist[s] == -1) { dist[s] = 0; q.push(s); }
         while (!q.empty()) {
             int u = q.front(); q.pop();
-            for (auto &pr : adj[u]) {
+            for (auto pr : g[u]) {
                 int v = pr.first;
                 if (dist[v] == -1) { dist[v] = dist[u] + 1; q.push(v); }
             }
@@ -76,19 +1377,65 @@ struct Graph {
         return dist;
     }
 
+    // ---------- DFS engine (iterative, visitor hooks) ----------
+    // One explicit-stack DFS behind every "recursive" algorithm below: it visits exactly in
+    // recursive order but has no depth limit, and the hooks are resolved at compile time, so
+    // they inline instead of going through std::function. A visitor derives from DFSVisitor
+    // and overrides the hooks it needs:
+    //   discover(u)      u is entered (preorder)
+    //   treeEdge(u, v)   v is unvisited and becomes u's child (discover(v) follows)
+    //   backEdge(u, v)   v is on the current DFS path (includes u -> u and the edge to the parent)
+    //   otherEdge(u, v)  v is already finished (forward or cross edge)
+    //   finish(u, p)     all arcs of u are done; p is u's DFS parent or -1 at the root
+    // color (0 = new, 1 = on path, 2 = done) and the stack buffer are owned by the caller, so
+    // repeated calls allocate nothing; the stack never exceeds one entry per vertex.
+    struct DFSVisitor {
+        void discover(int) {}
+        void treeEdge(int, int) {}
+        void backEdge(int, int) {}
+        void otherEdge(int, int) {}
+        void finish(int, int) {}
+    };
+    static int target(const pair<int, W>& pr) { return pr.first; }
+    static int target(int v) { return v; }  // plain vector<vector<int>> adjacency (trees, radj)
+    template<class G, class Vis> static void dfsVisit(const G& g, int root, Vis& vis, vector<char>& color, vector<pair<int, int>>& st) {
+        color[root] = 1; vis.discover(root); st.push_back({root, 0});
+        while (!st.empty()) {
+            int u = st.back().first, i = st.back().second;
+            if (i < (int)g[u].size()) {
+                st.back().second++;
+                int v = target(g[u][i]);
+                if (color[v] == 0) { vis.treeEdge(u, v); color[v] = 1; vis.discover(v); st.push_back({v, 0}); }
+                else if (color[v] == 1) vis.backEdge(u, v);
+                else vis.otherEdge(u, v);
+            } else {
+                color[u] = 2; st.pop_back();
+                vis.finish(u, st.empty() ? -1 : st.back().first);
+            }
+        }
+    }
+    // DFS from every still-new vertex in 0..n-1
+    template<class G, class Vis> static void dfsAll(const G& g, Vis& vis) {
+        int n = (int)g.size();
+        vector<char> color(n, 0); vector<pair<int, int>> st;
+        for (int i = 0; i < n; ++i) if (!color[i]) dfsVisit(g, i, vis, color, st);
+    }
+
     // ---------- DFS (recursive order) ----------
-    vector<int> depthFirstSearchRecursive(int src) const {
-        vector<int> order; vector<char> vis(n, 0);
-        function<void(int)> dfs = [&](int u) {
-            vis[u] = 1; order.push_back(u);
-            for (auto &pr : adj[u]) if (!vis[pr.first]) dfs(pr.first);
-        };
-        if (src >= 0 && src < n) dfs(src);
+    vector<int> depthFirstSearchRecursive(int src) const { return dfsRecursiveOn(adj, src); }
+    template<class G> static vector<int> dfsRecursiveOn(const G& g, int src) {
+        int n = (int)g.size();
+        vector<int> order;
+        struct V : DFSVisitor { vector<int>& order; void discover(int u) { order.push_back(u); } } vis{{}, order};
+        vector<char> color(n, 0); vector<pair<int, int>> st;
+        if (src >= 0 && src < n) dfsVisit(g, src, vis, color, st);
         return order;
     }
 
     // ---------- DFS (iterative) ----------
-    vector<int> depthFirstSearchIterative(int src) const {
+    vector<int> depthFirstSearchIterative(int src) const { return dfsIterativeOn(adj, src); }
+    template<class G> static vector<int> dfsIterativeOn(const G& g, int src) {
+        int n = (int)g.size();
         vector<int> order; if (src < 0 || src >= n) return order;
         vector<char> vis(n, 0);
         stack<int> st; st.push(src);
@@ -96,51 +1443,76 @@ struct Graph {
             int u = st.top(); st.pop();
             if (vis[u]) continue;
             vis[u] = 1; order.push_back(u);
-            for (int i = (int)adj[u].size() - 1; i >= 0; --i) {
-                int v = adj[u][i].first;
+            for (int i = (int)g[u].size() - 1; i >= 0; --i) {
+                int v = g[u][i].first;
                 if (!vis[v]) st.push(v);
             }
         }
         return order;
     }
+    // visit order ends up in ws.touched
+    void depthFirstSearchIterative(int src, Workspace& ws) const { dfsIterativeOn(adj, src, ws); }
+    template<class G> static void dfsIterativeOn(const G& g, int src, Workspace& ws) {
+        ws.begin((int)g.size());
+        if (src < 0 || src >= (int)g.size()) return;
+        ws.q.push_back(src);
+        while (!ws.q.empty()) {
+            int u = ws.q.back(); ws.q.pop_back();
+            if (ws.seen(u)) continue;
+            ws.set(u, (W)ws.touched.size(), -1);  // d = preorder index
+            for (int i = (int)g[u].size() - 1; i >= 0; --i) {
+                int v = g[u][i].first;
+                if (!ws.seen(v)) ws.q.push_back(v);
+            }
+        }
+    }
 
     // ---------- Topological sort (Kahn) ----------
     // returns empty vector if cycle detected
-    vector<int> topologicalSortKahn() const {
+    vector<int> topologicalSortKahn() const { return topoKahnOn(adj); }
+    template<class G> static vector<int> topoKahnOn(const G& g) {
+        int n = (int)g.size();
         vector<int> indeg(n, 0);
-        for (int u = 0; u < n; ++u) for (auto &pr : adj[u]) indeg[pr.first]++;
+        for (int u = 0; u < n; ++u) for (auto pr : g[u]) indeg[pr.first]++;
         queue<int> q;
         for (int i = 0; i < n; ++i) if (indeg[i] == 0) q.push(i);
         vector<int> topo;
         while (!q.empty()) {
             int u = q.front(); q.pop();
             topo.push_back(u);
-            for (auto &pr : adj[u]) if (--indeg[pr.first] == 0) q.push(pr.first);
+            for (auto pr : g[u]) if (--indeg[pr.first] == 0) q.push(pr.first);
         }
         if ((int)topo.size() != n) return {}; // cycle present
         return topo;
     }
 
     // ---------- Topological sort (DFS-based) ----------
-    vector<int> topologicalSortDFS() const {
-        vector<int> order; vector<char> vis(n, 0), inStack(n, 0); bool hasCycle = false;
-        function<void(int)> dfs = [&](int u) {
-            vis[u] = 1; inStack[u] = 1;
-            for (auto &pr : adj[u]) {
-                int v = pr.first;
-                if (!vis[v]) dfs(v);
-                else if (inStack[v]) hasCycle = true;
-            }
-            inStack[u] = 0; order.push_back(u);
-        };
-        for (int i = 0; i < n; ++i) if (!vis[i]) dfs(i);
+    vector<int> topologicalSortDFS() const { return topoDFSOn(adj); }
+    template<class G> static vector<int> topoDFSOn(const G& g) {
+        vector<int> order; bool hasCycle = false;
+        struct V : DFSVisitor {
+            vector<int>& order; bool& hasCycle;
+            void backEdge(int, int) { hasCycle = true; }
+            void finish(int u, int) { order.push_back(u); }
+        } vis{{}, order, hasCycle};
+        dfsAll(g, vis);
         if (hasCycle) return {};
         reverse(order.begin(), order.end());
         return order;
     }
 
     // ---------- Dijkstra (heap). returns {dist, parent} ----------
-    pair<vector<W>, vector<int>> dijkstra(int src) const {
+    // queue: LazyBinary  = std::priority_queue that keeps stale entries (up to E of them),
+    //        IndexedDAry = indexed 4-ary heap with decrease-key (at most n entries),
+    //        RadixHeap / DialBuckets = monotone integer queues (integral W only; Dial
+    //                      needs max weight <= DIAL_MAX_WEIGHT, else the radix heap is used),
+    //        Auto        = Dial when the largest weight is small, else radix heap; IndexedDAry
+    //                      for non-integral W
+    pair<vector<W>, vector<int>> dijkstra(int src, SSSPQueue queue = SSSPQueue::LazyBinary) const { return dijkstraOn(adj, src, queue); }
+    template<class G> static pair<vector<W>, vector<int>> dijkstraOn(const G& g, int src, SSSPQueue queue = SSSPQueue::LazyBinary) {
+        if (queue == SSSPQueue::IndexedDAry) return dijkstraIndexedOn<4>(g, src);
+        if (queue != SSSPQueue::LazyBinary) return dijkstraIntegerOn(g, src, queue);
+        int n = (int)g.size();
         const W INF = numeric_limits<W>::max() / 4;
         vector<W> dist(n, INF);
         vector<int> parent(n, -1);
@@ -151,7 +1523,7 @@ struct Graph {
         while (!pq.empty()) {
             auto [d, u] = pq.top(); pq.pop();
             if (d != dist[u]) continue;
-            for (auto &pr : adj[u]) {
+            for (auto pr : g[u]) {
                 int v = pr.first; W w = pr.second;
                 if (w < 0) continue; // negative weights not supported
                 if (dist[v] > dist[u] + w) {
@@ -164,14 +1536,204 @@ struct Graph {
         return {dist, parent};
     }
 
+    // ---------- Indexed d-ary heap ----------
+    // Min-heap of vertex ids keyed by key[v], with pos[v] = slot in h (-1 if absent), so each
+    // vertex is stored at most once and push() on a present vertex is a decrease-key. A wider
+    // node (D = 4) halves the height of a binary heap and keeps siblings in one cache line.
+    template<int D = 4> struct IndexedHeap {
+        vector<int> h, pos; vector<W> key;
+        void init(int n) { h.clear(); pos.assign(n, -1); key.resize(n); }
+        bool empty() const { return h.empty(); }
+        void push(int v, W k) {
+            if (pos[v] == -1) { pos[v] = (int)h.size(); h.push_back(v); }
+            else if (!(k < key[v])) return;
+            key[v] = k; up(pos[v]);
+        }
+        int pop() {
+            int top = h[0], last = h.back();
+            h.pop_back(); pos[top] = -1;
+            if (!h.empty()) { h[0] = last; pos[last] = 0; down(0); }
+            return top;
+        }
+        void up(int i) {
+            int v = h[i];
+            while (i > 0) { int p = (i - 1) / D; if (!(key[v] < key[h[p]])) break; h[i] = h[p]; pos[h[i]] = i; i = p; }
+            h[i] = v; pos[v] = i;
+        }
+        void down(int i) {
+            int v = h[i], sz = (int)h.size();
+            while (true) {
+                int c = i * D + 1; if (c >= sz) break;
+                int best = c;
+                for (int j = c + 1; j < min(sz, c + D); ++j) if (key[h[j]] < key[h[best]]) best = j;
+                if (!(key[h[best]] < key[v])) break;
+                h[i] = h[best]; pos[h[i]] = i; i = best;
+            }
+            h[i] = v; pos[v] = i;
+        }
+    };
+    template<int D> pair<vector<W>, vector<int>> dijkstraIndexed(int src) const { return dijkstraIndexedOn<D>(adj, src); }
+    template<int D, class G> static pair<vector<W>, vector<int>> dijkstraIndexedOn(const G& g, int src) {
+        int n = (int)g.size();
+        const W INF = numeric_limits<W>::max() / 4;
+        vector<W> dist(n, INF);
+        vector<int> parent(n, -1);
+        if (src < 0 || src >= n) return {dist, parent};
+        IndexedHeap<D> pq; pq.init(n);
+        dist[src] = 0; pq.push(src, 0);
+        while (!pq.empty()) {
+            int u = pq.pop();
+            for (auto pr : g[u]) {
+                int v = pr.first; W w = pr.second;
+                if (w < 0) continue; // negative weights not supported
+                if (dist[v] > dist[u] + w) {
+                    dist[v] = dist[u] + w;
+                    parent[v] = u;
+                    pq.push(v, dist[v]);
+                }
+            }
+        }
+        return {dist, parent};
+    }
+
+    // ---------- Monotone integer queues ----------
+    // Dijkstra only ever pops keys >= the last popped one, which lets integer keys skip
+    // comparisons entirely.
+    // Radix heap: bucket i > 0 holds keys whose highest bit differing from `last` is bit i-1;
+    // popping refills bucket 0 from the first non-empty bucket, and a key moves to a lower
+    // bucket at most 64 times, so operations are O(1) amortized plus O(log C) per key.
+    struct RadixHeap {
+        using K = unsigned long long;
+        vector<pair<K, int>> b[65]; K last = 0; size_t sz = 0;
+        static int bucketOf(K x, K last) { return x == last ? 0 : 64 - __builtin_clzll(x ^ last); }
+        bool empty() const { return sz == 0; }
+        void push(K k, int v) { b[bucketOf(k, last)].push_back({k, v}); ++sz; }
+        pair<K, int> pop() {
+            if (b[0].empty()) {
+                int i = 1; while (b[i].empty()) ++i;
+                last = min_element(b[i].begin(), b[i].end())->first;
+                for (auto &x : b[i]) b[bucketOf(x.first, last)].push_back(x);
+                b[i].clear();
+            }
+            auto x = b[0].back(); b[0].pop_back(); --sz;
+            return x;
+        }
+    };
+    // Dial: with weights <= C every pending key lies in [cur, cur + C], so C + 1 circular
+    // buckets indexed by key % (C + 1) form an exact priority queue scanned in key order.
+    // Above DIAL_MAX_WEIGHT the buckets cost more than they save, so DialBuckets (like Auto)
+    // falls back to the radix heap instead of allocating C + 1 vectors.
+    static constexpr ll DIAL_MAX_WEIGHT = 4096;
+    template<class G> static pair<vector<W>, vector<int>> dijkstraIntegerOn(const G& g, int src, SSSPQueue queue) {
+        if constexpr (!is_integral<W>::value) return dijkstraIndexedOn<4>(g, src);
+        else {
+            int n = (int)g.size();
+            const W INF = numeric_limits<W>::max() / 4;
+            vector<W> dist(n, INF);
+            vector<int> parent(n, -1);
+            if (src < 0 || src >= n) return {dist, parent};
+            W maxW = 0;
+            if (queue != SSSPQueue::RadixHeap) for (int u = 0; u < n; ++u) for (auto pr : g[u]) maxW = max(maxW, pr.second);
+            if (queue == SSSPQueue::Auto || queue == SSSPQueue::DialBuckets)
+                queue = (ll)maxW <= DIAL_MAX_WEIGHT ? SSSPQueue::DialBuckets : SSSPQueue::RadixHeap;
+            auto relax = [&](int u, auto push) {
+                for (auto pr : g[u]) {
+                    int v = pr.first; W w = pr.second;
+                    if (w < 0) continue; // negative weights not supported
+                    if (dist[v] > dist[u] + w) { dist[v] = dist[u] + w; parent[v] = u; push(v); }
+                }
+            };
+            dist[src] = 0;
+            if (queue == SSSPQueue::DialBuckets) {
+                ll B = (ll)maxW + 1, pending = 1;
+                vector<vector<int>> bucket(B);
+                bucket[0].push_back(src);
+                for (W cur = 0; pending; ++cur) {
+                    auto &b = bucket[cur % B];
+                    while (!b.empty()) {  // zero-weight arcs refill this bucket while it drains
+                        int u = b.back(); b.pop_back(); --pending;
+                        if (dist[u] != cur) continue;
+                        relax(u, [&](int v) { bucket[dist[v] % B].push_back(v); ++pending; });
+                    }
+                }
+            } else {
+                RadixHeap pq; pq.push(0, src);
+                while (!pq.empty()) {
+                    auto [d, u] = pq.pop();
+                    if ((W)d != dist[u]) continue;
+                    relax(u, [&](int v) { pq.push((unsigned long long)dist[v], v); });
+                }
+            }
+            return {dist, parent};
+        }
+    }
+
+    void dijkstra(int src, Workspace& ws) const { dijkstraOn(adj, src, ws); }
+    template<class G> static void dijkstraOn(const G& g, int src, Workspace& ws) {
+        ws.begin((int)g.size());
+        if (src < 0 || src >= (int)g.size()) return;
+        auto &h = ws.heap; auto later = greater<pair<W, int>>();
+        ws.set(src, 0, -1); h.push_back({0, src});
+        while (!h.empty()) {
+            pop_heap(h.begin(), h.end(), later);
+            auto [d, u] = h.back(); h.pop_back();
+            if (d != ws.d[u]) continue;
+            for (auto pr : g[u]) {
+                int v = pr.first; W w = pr.second;
+                if (w < 0) continue; // negative weights not supported
+                if (!ws.seen(v) || ws.d[v] > d + w) { ws.set(v, d + w, u); h.push_back({d + w, v}); push_heap(h.begin(), h.end(), later); }
+            }
+        }
+    }
+
+    // ---------- A* (goal-directed point-to-point) ----------
+    // Dijkstra ordered by d(s, v) + h(v), stopped once t is settled. h is any callable int -> W,
+    // taken as a template argument so it inlines. It must not overestimate d(v, t); if it is
+    // also consistent (h(u) <= w(u, v) + h(v)) every vertex is settled once. h(v) >= INF marks
+    // v as unable to reach t. h = 0 is plain Dijkstra; Landmarks::heuristic(t) gives ALT.
+    // Returns {distance, path s..t}, {INF = max/4, {}} if unreachable; ws.touched lists the
+    // vertices reached.
+    template<class H> pair<W, vector<int>> astar(int s, int t, H h) const { Workspace ws; return astarOn(adj, s, t, h, ws); }
+    template<class H> pair<W, vector<int>> astar(int s, int t, H h, Workspace& ws) const { return astarOn(adj, s, t, h, ws); }
+    template<class G, class H> static pair<W, vector<int>> astarOn(const G& g, int s, int t, H h, Workspace& ws) {
+        const W INF = numeric_limits<W>::max() / 4;
+        int n = (int)g.size();
+        ws.begin(n);
+        if (s < 0 || s >= n || t < 0 || t >= n || h(s) >= INF) return {INF, {}};
+        auto &pq = ws.heap; auto later = greater<pair<W, int>>();
+        ws.set(s, 0, -1); pq.push_back({h(s), s});
+        while (!pq.empty()) {
+            pop_heap(pq.begin(), pq.end(), later);
+            auto [f, u] = pq.back(); pq.pop_back();
+            W d = ws.d[u];
+            if (f != d + h(u)) continue;  // stale entry
+            if (u == t) break;
+            for (auto pr : g[u]) {
+                int v = pr.first; W w = pr.second;
+                if (w < 0) continue; // negative weights not supported
+                if (ws.seen(v) && ws.d[v] <= d + w) continue;
+                W hv = h(v);
+                if (hv >= INF) continue;
+                ws.set(v, d + w, u); pq.push_back({d + w + hv, v}); push_heap(pq.begin(), pq.end(), later);
+            }
+        }
+        if (!ws.seen(t)) return {INF, {}};
+        vector<int> path;
+        for (int v = t; v != -1; v = ws.par[v]) path.push_back(v);
+        reverse(path.begin(), path.end());
+        return {ws.d[t], path};
+    }
+
     // ---------- 0-1 BFS (weights 0 or 1) ----------
-    vector<W> zeroOneBFS(int src, W INF_VAL = (W)4e18) const {
+    vector<W> zeroOneBFS(int src, W INF_VAL = (W)4e18) const { return zeroOneBFSOn(adj, src, INF_VAL); }
+    template<class G> static vector<W> zeroOneBFSOn(const G& g, int src, W INF_VAL) {
+        int n = (int)g.size();
         vector<W> dist(n, INF_VAL);
         if (src < 0 || src >= n) return dist;
         deque<int> dq; dist[src] = 0; dq.push_front(src);
         while (!dq.empty()) {
             int u = dq.front(); dq.pop_front();
-            for (auto &pr : adj[u]) {
+            for (auto pr : g[u]) {
                 int v = pr.first; W w = pr.second;
                 if (dist[v] > dist[u] + w) {
                     dist[v] = dist[u] + w;
@@ -181,23 +1743,110 @@ struct Graph {
         }
         return dist;
     }
+    void zeroOneBFS(int src, Workspace& ws) const { zeroOneBFSOn(adj, src, ws); }
+    template<class G> static void zeroOneBFSOn(const G& g, int src, Workspace& ws) {
+        ws.begin((int)g.size());
+        if (src < 0 || src >= (int)g.size()) return;
+        ws.set(src, 0, -1); ws.dq.push_front(src);
+        while (!ws.dq.empty()) {
+            int u = ws.dq.front(); ws.dq.pop_front();
+            for (auto pr : g[u]) {
+                int v = pr.first; W w = pr.second;
+                if (!ws.seen(v) || ws.d[v] > ws.d[u] + w) {
+                    ws.set(v, ws.d[u] + w, u);
+                    if (w == 0) ws.dq.push_front(v); else ws.dq.push_back(v);
+                }
+            }
+        }
+    }
+
+    // ---------- Early-terminating searches ----------
+    // searchOn settles vertices in nondecreasing distance and hands each one to visit(v, d),
+    // stopping as soon as it returns false, so a search that stops after k vertices costs about
+    // their arcs rather than O(n + m). The stopping modes built on it return (vertex, dist)
+    // pairs in settle order; ws keeps dist / parent of everything reached.
+    //   ball:        every vertex with dist <= radius
+    //   nearest:     the k closest vertices with pred(v)
+    //   distancesTo: the reachable vertices of `targets`, stopping once all of them are settled
+    template<class G, class F> static void searchOn(const G& g, int src, SearchKind kind, Workspace& ws, F visit) {
+        int n = (int)g.size();
+        ws.begin(n);
+        if (src < 0 || src >= n) return;
+        ws.set(src, 0, -1);
+        if (kind == SearchKind::BFS) {
+            ws.q.push_back(src);
+            for (size_t i = 0; i < ws.q.size(); ++i) {
+                int u = ws.q[i]; W d = ws.d[u];
+                if (!visit(u, d)) return;
+                for (auto pr : g[u]) if (!ws.seen(pr.first)) { ws.set(pr.first, d + 1, u); ws.q.push_back(pr.first); }
+            }
+        } else if (kind == SearchKind::ZeroOneBFS) {
+            ws.dq.push_back(src);
+            while (!ws.dq.empty()) {
+                int u = ws.dq.front(); ws.dq.pop_front();
+                if (!ws.settle(u)) continue;
+                W d = ws.d[u];
+                if (!visit(u, d)) return;
+                for (auto pr : g[u]) {
+                    int v = pr.first; W w = pr.second;
+                    if (!ws.seen(v) || ws.d[v] > d + w) {
+                        ws.set(v, d + w, u);
+                        if (w == 0) ws.dq.push_front(v); else ws.dq.push_back(v);
+                    }
+                }
+            }
+        } else {
+            auto &h = ws.heap; auto later = greater<pair<W, int>>();
+            h.push_back({0, src});
+            while (!h.empty()) {
+                pop_heap(h.begin(), h.end(), later);
+                auto [d, u] = h.back(); h.pop_back();
+                if (d != ws.d[u]) continue;
+                if (!visit(u, d)) return;
+                for (auto pr : g[u]) {
+                    int v = pr.first; W w = pr.second;
+                    if (w < 0) continue; // negative weights not supported
+                    if (!ws.seen(v) || ws.d[v] > d + w) { ws.set(v, d + w, u); h.push_back({d + w, v}); push_heap(h.begin(), h.end(), later); }
+                }
+            }
+        }
+    }
+    template<class G> static vector<pair<int, W>> ballOn(const G& g, int src, W radius, Workspace& ws, SearchKind kind) {
+        vector<pair<int, W>> out;
+        searchOn(g, src, kind, ws, [&](int v, W d) { if (d > radius) return false; out.push_back({v, d}); return true; });
+        return out;
+    }
+    template<class G, class P> static vector<pair<int, W>> nearestOn(const G& g, int src, int k, P pred, Workspace& ws, SearchKind kind) {
+        vector<pair<int, W>> out;
+        if (k <= 0) return out;
+        searchOn(g, src, kind, ws, [&](int v, W d) { if (pred(v)) out.push_back({v, d}); return (int)out.size() < k; });
+        return out;
+    }
+    template<class G> static vector<pair<int, W>> distancesToOn(const G& g, int src, vector<int> targets, Workspace& ws, SearchKind kind) {
+        vector<pair<int, W>> out;
+        int n = (int)g.size();
+        targets.erase(remove_if(targets.begin(), targets.end(), [n](int t) { return t < 0 || t >= n; }), targets.end());
+        sort(targets.begin(), targets.end());
+        targets.erase(unique(targets.begin(), targets.end()), targets.end());
+        if (targets.empty()) return out;
+        searchOn(g, src, kind, ws, [&](int v, W d) {
+            if (binary_search(targets.begin(), targets.end(), v)) out.push_back({v, d});
+            return out.size() < targets.size();
+        });
+        return out;
+    }
+    template<class F> void search(int src, SearchKind kind, Workspace& ws, F visit) const { searchOn(adj, src, kind, ws, visit); }
+    vector<pair<int, W>> ball(int src, W radius, Workspace& ws, SearchKind kind = SearchKind::Dijkstra) const { return ballOn(adj, src, radius, ws, kind); }
+    template<class P> vector<pair<int, W>> nearest(int src, int k, P pred, Workspace& ws, SearchKind kind = SearchKind::Dijkstra) const { return nearestOn(adj, src, k, pred, ws, kind); }
+    vector<pair<int, W>> distancesTo(int src, const vector<int>& targets, Workspace& ws, SearchKind kind = SearchKind::Dijkstra) const { return distancesToOn(adj, src, targets, ws, kind); }
 
     // ---------- Bellman-Ford: returns (dist, hasNegativeCycle, parent) ----------
-    tuple<vector<W>, bool, vector<int>> bellmanFord(int src) const {
+    // runs over a unique edge list (for undirected use u<v)
+    tuple<vector<W>, bool, vector<int>> bellmanFord(int src) const { return bellmanFordOn(n, directed ? edges : edgesForMST(), src); }
+    static tuple<vector<W>, bool, vector<int>> bellmanFordOn(int n, const vector<Edge>& E, int src) {
         const W INF = numeric_limits<W>::max() / 4;
         vector<W> dist(n, INF); vector<int> parent(n, -1);
         if (src < 0 || src >= n) return {dist, false, parent};
-        // build unique edge list (for undirected use u<v)
-        vector<Edge> E;
-        if (directed) E = edges;
-        else {
-            set<pair<pair<int, int>, W>> s;
-            for (int u = 0; u < n; ++u) for (auto &pr : adj[u]) {
-                    int v = pr.first; W w = pr.second;
-                    if (u < v) s.insert({{u, v}, w});
-                }
-            for (auto &it : s) E.emplace_back(it.first.first, it.first.second, it.second);
-        }
         dist[src] = 0;
         for (int i = 0; i < n - 1; ++i) {
             bool any = false;
@@ -214,15 +1863,92 @@ struct Graph {
         for (auto &e : E) if (dist[e.u] < INF && dist[e.v] > dist[e.u] + e.w) { negCycle = true; break; }
         return {dist, negCycle, parent};
     }
+    // Workspace version: rounds only rescan the arcs of vertices reached so far, relaxing the
+    // stored arcs (both directions of an undirected edge). Returns hasNegativeCycle.
+    bool bellmanFord(int src, Workspace& ws) const { return bellmanFordOn(adj, src, ws); }
+    template<class G> static bool bellmanFordOn(const G& g, int src, Workspace& ws) {
+        int n = (int)g.size();
+        ws.begin(n);
+        if (src < 0 || src >= n) return false;
+        ws.set(src, 0, -1);
+        auto round = [&](bool apply) {
+            bool any = false;
+            for (size_t i = 0; i < ws.touched.size(); ++i) {
+                int u = ws.touched[i];
+                for (auto pr : g[u]) {
+                    int v = pr.first; W w = pr.second;
+                    if (!ws.seen(v) || ws.d[v] > ws.d[u] + w) { any = true; if (!apply) return true; ws.set(v, ws.d[u] + w, u); }
+                }
+            }
+            return any;
+        };
+        for (int i = 0; i < n - 1; ++i) if (!round(true)) break;
+        return round(false);
+    }
+
+    // ---------- Negative cycle: queue-based Bellman-Ford with subtree disassembly ----------
+    // Returns the first negative cycle reachable from src as (vertices, arcs), arcs[i] going
+    // vertices[i] -> vertices[i+1] (cyclically); both empty if there is none. src = -1 starts
+    // every vertex at distance 0 (any negative cycle). The shortest-path tree is kept as a
+    // preorder list; when v improves, its subtree is cut out and left idle until relabelled,
+    // and finding the scanning vertex u inside it is exactly a cycle in the parent graph
+    // (Tarjan), so the search stops as soon as a cycle forms instead of after n-1 rounds.
+    // Undirected edges are two arcs, so a negative edge is itself a cycle of length 2.
+    pair<vector<int>, vector<Edge>> negativeCycle(int src = -1) const { return negativeCycleOn(adj, src); }
+    template<class G> static pair<vector<int>, vector<Edge>> negativeCycleOn(const G& g, int src) {
+        int n = (int)g.size(), root = src < 0 ? n : src;
+        if (src >= n) return {};
+        const W INF = numeric_limits<W>::max() / 4;
+        vector<W> d(n + 1, src < 0 ? 0 : INF), pw(n + 1, 0);
+        vector<int> par(n + 1, -1), depth(n + 1, 0), nxt(n + 1), prv(n + 1);
+        vector<char> inTree(n + 1, 0), queued(n + 1, 0);
+        deque<int> q;
+        nxt[root] = prv[root] = root; inTree[root] = 1; d[root] = 0;
+        if (src < 0) {
+            // virtual root n with every vertex hanging off it at distance 0
+            for (int v = 0; v < n; ++v) {
+                par[v] = root; depth[v] = 1; inTree[v] = queued[v] = 1; q.push_back(v);
+                nxt[v] = root; prv[v] = prv[root]; nxt[prv[root]] = v; prv[root] = v;
+            }
+        } else { queued[src] = 1; q.push_back(src); }
+        while (!q.empty()) {
+            int u = q.front(); q.pop_front(); queued[u] = 0;
+            if (!inTree[u]) continue; // disassembled: idle until relabelled
+            for (auto pr : g[u]) {
+                int v = pr.first; W w = pr.second;
+                if (d[v] <= d[u] + w) continue;
+                bool cycle = u == v;
+                if (inTree[v]) {
+                    int x = nxt[v];
+                    for (; depth[x] > depth[v]; x = nxt[x]) { if (x == u) cycle = true; inTree[x] = 0; }
+                    nxt[prv[v]] = x; prv[x] = prv[v];
+                }
+                if (cycle) {
+                    // u descends from v: the tree path v -> ... -> u closed by the arc u -> v
+                    vector<int> cyc; vector<Edge> arcs{Edge(u, v, w)};
+                    for (int x = u; x != v; x = par[x]) { cyc.push_back(x); arcs.push_back(Edge(par[x], x, pw[x])); }
+                    cyc.push_back(v);
+                    reverse(cyc.begin(), cyc.end()); reverse(arcs.begin(), arcs.end());
+                    return {cyc, arcs};
+                }
+                d[v] = d[u] + w; pw[v] = w; par[v] = u; depth[v] = depth[u] + 1; inTree[v] = 1;
+                nxt[v] = nxt[u]; prv[nxt[u]] = v; nxt[u] = v; prv[v] = u;
+                if (!queued[v]) { queued[v] = 1; q.push_back(v); }
+            }
+        }
+        return {};
+    }
 
     // ---------- Shortest path on DAG ----------
-    vector<W> shortestPathOnDAG(int src, W INF_VAL = numeric_limits<W>::max() / 4) const {
-        auto topo = topologicalSortDFS();
+    vector<W> shortestPathOnDAG(int src, W INF_VAL = numeric_limits<W>::max() / 4) const { return shortestPathOnDAGOn(adj, src, INF_VAL); }
+    template<class G> static vector<W> shortestPathOnDAGOn(const G& g, int src, W INF_VAL) {
+        int n = (int)g.size();
+        auto topo = topoDFSOn(g);
         if (topo.empty()) return {}; // not DAG or cycle
         vector<W> dist(n, INF_VAL); dist[src] = 0;
         for (int u : topo) {
             if (dist[u] == INF_VAL) continue;
-            for (auto &pr : adj[u]) {
+            for (auto pr : g[u]) {
                 int v = pr.first; W w = pr.second;
                 if (dist[v] > dist[u] + w) dist[v] = dist[u] + w;
             }
@@ -244,9 +1970,11 @@ struct Graph {
     };
 
     // return unique undirected edges (u < v)
-    vector<Edge> edgesForMST() const {
+    vector<Edge> edgesForMST() const { return edgesForMSTOn(adj); }
+    template<class G> static vector<Edge> edgesForMSTOn(const G& g) {
+        int n = (int)g.size();
         set<pair<pair<int, int>, W>> s;
-        for (int u = 0; u < n; ++u) for (auto &pr : adj[u]) {
+        for (int u = 0; u < n; ++u) for (auto pr : g[u]) {
                 int v = pr.first; W w = pr.second;
                 if (u < v) s.insert({{u, v}, w});
             }
@@ -256,9 +1984,8 @@ struct Graph {
     }
 
     // ---------- Kruskal MST (undirected) ----------
-    pair<W, vector<Edge>> kruskalMST() const {
-        if (directed) return {0, {}};
-        auto uniq = edgesForMST();
+    pair<W, vector<Edge>> kruskalMST() const { if (directed) return {0, {}}; return kruskalOn(n, edgesForMST()); }
+    static pair<W, vector<Edge>> kruskalOn(int n, vector<Edge> uniq) {
         sort(uniq.begin(), uniq.end(), [](const Edge & a, const Edge & b) { return a.w < b.w; });
         DSU dsu(n); vector<Edge> used; W total = 0;
         for (auto &e : uniq) if (dsu.unite(e.u, e.v)) { used.push_back(e); total += e.w; }
@@ -266,7 +1993,9 @@ struct Graph {
     }
 
     // ---------- Prim MST ----------
-    pair<W, vector<int>> primMST(int src = 0) const {
+    pair<W, vector<int>> primMST(int src = 0) const { return primOn(adj, src); }
+    template<class G> static pair<W, vector<int>> primOn(const G& g, int src) {
+        int n = (int)g.size();
         const W INF = numeric_limits<W>::max() / 4;
         vector<W> key(n, INF); vector<int> parent(n, -1); vector<char> inMST(n, 0);
         using P = pair<W, int>;
@@ -276,7 +2005,7 @@ struct Graph {
             auto [k, u] = pq.top(); pq.pop();
             if (inMST[u]) continue;
             inMST[u] = 1;
-            for (auto &pr : adj[u]) {
+            for (auto pr : g[u]) {
                 int v = pr.first; W w = pr.second;
                 if (!inMST[v] && w < key[v]) { key[v] = w; parent[v] = u; pq.push({key[v], v}); }
             }
@@ -287,62 +2016,108 @@ struct Graph {
     }
 
     // ---------- Strongly Connected Components (Kosaraju) ----------
-    vector<vector<int>> kosarajuSCC() const {
-        vector<char> vis(n, 0); vector<int> order;
-        function<void(int)> dfs1 = [&](int u) { vis[u] = 1; for (auto &pr : adj[u]) if (!vis[pr.first]) dfs1(pr.first); order.push_back(u); };
-        for (int i = 0; i < n; ++i) if (!vis[i]) dfs1(i);
+    vector<vector<int>> kosarajuSCC() const { return kosarajuOn(adj); }
+    template<class G> static vector<vector<int>> kosarajuOn(const G& g) {
+        int n = (int)g.size();
+        vector<int> order;
+        struct Post : DFSVisitor { vector<int>& order; void finish(int u, int) { order.push_back(u); } } post{{}, order};
+        dfsAll(g, post);
         vector<vector<int>> radj(n);
-        for (int u = 0; u < n; ++u) for (auto &pr : adj[u]) radj[pr.first].push_back(u);
-        vis.assign(n, 0);
+        for (int u = 0; u < n; ++u) for (auto pr : g[u]) radj[pr.first].push_back(u);
         vector<vector<int>> comps;
-        function<void(int, vector<int>&)> dfs2 = [&](int u, vector<int>& comp) { vis[u] = 1; comp.push_back(u); for (int v : radj[u]) if (!vis[v]) dfs2(v, comp); };
-        for (int i = (int)order.size() - 1; i >= 0; --i) if (!vis[order[i]]) { vector<int> comp; dfs2(order[i], comp); comps.push_back(comp); }
+        struct Pre : DFSVisitor { vector<int>* comp; void discover(int u) { comp->push_back(u); } } pre{{}, nullptr};
+        vector<char> color(n, 0); vector<pair<int, int>> st;
+        for (int i = (int)order.size() - 1; i >= 0; --i) if (!color[order[i]]) { vector<int> comp; pre.comp = &comp; dfsVisit(radj, order[i], pre, color, st); comps.push_back(comp); }
         return comps;
     }
 
     // ---------- Tarjan SCC ----------
-    vector<vector<int>> tarjanSCC() const {
-        vector<int> disc(n, -1), low(n, -1), st; vector<char> inSt(n, 0);
-        int time = 0; vector<vector<int>> comps;
-        function<void(int)> dfs = [&](int u) {
-            disc[u] = low[u] = time++; st.push_back(u); inSt[u] = 1;
-            for (auto &pr : adj[u]) {
-                int v = pr.first;
-                if (disc[v] == -1) { dfs(v); low[u] = min(low[u], low[v]); }
-                else if (inSt[v]) low[u] = min(low[u], disc[v]);
+    vector<vector<int>> tarjanSCC() const { return tarjanOn(adj); }
+    template<class G> static vector<vector<int>> tarjanOn(const G& g) {
+        int n = (int)g.size();
+        struct V : DFSVisitor {
+            vector<int> disc, low, st; vector<char> inSt; int time = 0; vector<vector<int>> comps;
+            void discover(int u) { disc[u] = low[u] = time++; st.push_back(u); inSt[u] = 1; }
+            void backEdge(int u, int v) { if (inSt[v]) low[u] = min(low[u], disc[v]); }
+            void otherEdge(int u, int v) { if (inSt[v]) low[u] = min(low[u], disc[v]); }
+            void finish(int u, int p) {
+                if (low[u] == disc[u]) {
+                    vector<int> comp;
+                    while (!st.empty()) { int w = st.back(); st.pop_back(); inSt[w] = 0; comp.push_back(w); if (w == u) break; }
+                    comps.push_back(comp);
+                }
+                if (p != -1) low[p] = min(low[p], low[u]);
             }
-            if (low[u] == disc[u]) {
-                vector<int> comp;
-                while (!st.empty()) { int w = st.back(); st.pop_back(); inSt[w] = 0; comp.push_back(w); if (w == u) break; }
-                comps.push_back(comp);
+        } vis;
+        vis.disc.assign(n, -1); vis.low.assign(n, -1); vis.inSt.assign(n, 0);
+        dfsAll(g, vis);
+        return vis.comps;
+    }
+
+    // ---------- SCC as flat labels + condensation DAG ----------
+    // Tarjan on the DFS engine writing comp[v] directly (no per-component vectors). Components
+    // are numbered in topological order of the condensation: every arc between two components
+    // goes from a lower id to a higher one.
+    Components stronglyConnectedComponents() const { return Components::fromLabels(sccLabelsOn(adj)); }
+    template<class G> static vector<int> sccLabelsOn(const G& g) {
+        int n = (int)g.size();
+        struct V : DFSVisitor {
+            vector<int> disc, low, st, comp; int time = 0, found = 0;
+            void discover(int u) { disc[u] = low[u] = time++; st.push_back(u); }
+            void backEdge(int u, int v) { if (comp[v] == -1) low[u] = min(low[u], disc[v]); }
+            void otherEdge(int u, int v) { if (comp[v] == -1) low[u] = min(low[u], disc[v]); }
+            void finish(int u, int p) {
+                if (low[u] == disc[u]) { int w; do { w = st.back(); st.pop_back(); comp[w] = found; } while (w != u); ++found; }
+                if (p != -1) low[p] = min(low[p], low[u]);
             }
-        };
-        for (int i = 0; i < n; ++i) if (disc[i] == -1) dfs(i);
-        return comps;
+        } vis;
+        vis.disc.assign(n, -1); vis.low.assign(n, -1); vis.comp.assign(n, -1);
+        dfsAll(g, vis);
+        for (int &c : vis.comp) c = vis.found - 1 - c;  // Tarjan finds sinks first
+        return vis.comp;
+    }
+    // Frozen DAG with one vertex per component and one arc per connected pair of components
+    // (parallel arcs merged, keeping the smallest weight); arcs inside a component are dropped.
+    CSR condensation(const Components& c) const { return condensationOn(adj, c); }
+    template<class G> static CSR condensationOn(const G& g, const Components& c) {
+        auto a = make_shared<typename CSR::Arrays>();
+        a->off.assign(c.count + 1, 0);
+        vector<int> seenFrom(c.count, -1); vector<ll> slot(c.count);
+        for (int x = 0; x < c.count; ++x) {
+            for (const int* v = c.begin(x); v != c.end(x); ++v) for (auto pr : g[*v]) {
+                    int y = c.comp[pr.first];
+                    if (y == x) continue;
+                    if (seenFrom[y] != x) { seenFrom[y] = x; slot[y] = (ll)a->to.size(); a->to.push_back(y); a->wt.push_back(pr.second); }
+                    else a->wt[slot[y]] = min(a->wt[slot[y]], pr.second);
+                }
+            a->off[x + 1] = (ll)a->to.size();
+        }
+        a->to.shrink_to_fit(); a->wt.shrink_to_fit();
+        return CSR::adopt(a, true);
     }
 
     // ---------- Bridges and Articulation Points ----------
-    pair<vector<pair<int, int>>, vector<int>> findBridgesAndArticulationPoints() const {
-        vector<int> tin(n, -1), low(n, -1), parent(n, -1);
-        vector<char> visited(n, 0), isArt(n, 0);
-        int timer = 0; vector<pair<int, int>> bridges;
-        function<void(int)> dfs = [&](int u) {
-            visited[u] = 1; tin[u] = low[u] = timer++; int children = 0;
-            for (auto &pr : adj[u]) {
-                int v = pr.first;
-                if (v == parent[u]) continue;
-                if (visited[v]) low[u] = min(low[u], tin[v]);
-                else {
-                    parent[v] = u; children++; dfs(v); low[u] = min(low[u], low[v]);
-                    if (low[v] > tin[u]) bridges.emplace_back(u, v);
-                    if (parent[u] != -1 && low[v] >= tin[u]) isArt[u] = 1;
-                }
+    pair<vector<pair<int, int>>, vector<int>> findBridgesAndArticulationPoints() const { return bridgesOn(adj); }
+    template<class G> static pair<vector<pair<int, int>>, vector<int>> bridgesOn(const G& g) {
+        int n = (int)g.size();
+        struct V : DFSVisitor {
+            vector<int> tin, low, parent, children; vector<char> isArt;
+            int timer = 0; vector<pair<int, int>> bridges;
+            void discover(int u) { tin[u] = low[u] = timer++; }
+            void treeEdge(int u, int v) { parent[v] = u; children[u]++; }
+            void backEdge(int u, int v) { if (v != parent[u]) low[u] = min(low[u], tin[v]); }
+            void otherEdge(int u, int v) { if (v != parent[u]) low[u] = min(low[u], tin[v]); }
+            void finish(int v, int u) {
+                if (u == -1) { if (children[v] > 1) isArt[v] = 1; return; }
+                low[u] = min(low[u], low[v]);
+                if (low[v] > tin[u]) bridges.emplace_back(u, v);
+                if (parent[u] != -1 && low[v] >= tin[u]) isArt[u] = 1;
             }
-            if (parent[u] == -1 && children > 1) isArt[u] = 1;
-        };
-        for (int i = 0; i < n; ++i) if (!visited[i]) dfs(i);
-        vector<int> arts; for (int i = 0; i < n; ++i) if (isArt[i]) arts.push_back(i);
-        return {bridges, arts};
+        } vis;
+        vis.tin.assign(n, -1); vis.low.assign(n, -1); vis.parent.assign(n, -1); vis.children.assign(n, 0); vis.isArt.assign(n, 0);
+        dfsAll(g, vis);
+        vector<int> arts; for (int i = 0; i < n; ++i) if (vis.isArt[i]) arts.push_back(i);
+        return {vis.bridges, arts};
     }
 
     // ---------- LCA (Binary Lifting) for trees ----------
@@ -355,11 +2130,12 @@ struct Graph {
         }
         void buildFromTreeAdj(const vector<vector<int>>& tree, int root = 0) {
             init((int)tree.size());
-            function<void(int, int)> dfs = [&](int u, int p) {
-                up[0][u] = p;
-                for (int v : tree[u]) if (v != p) { depth[v] = depth[u] + 1; dfs(v, u); }
-            };
-            depth[root] = 0; dfs(root, -1);
+            struct V : DFSVisitor {
+                LCA& L;
+                void treeEdge(int u, int v) { L.up[0][v] = u; L.depth[v] = L.depth[u] + 1; }
+            } vis{{}, *this};
+            vector<char> color(N, 0); vector<pair<int, int>> st;
+            depth[root] = 0; up[0][root] = -1; dfsVisit(tree, root, vis, color, st);
             for (int k = 1; k < LOG; ++k) for (int v = 0; v < N; ++v) up[k][v] = (up[k - 1][v] == -1) ? -1 : up[k - 1][ up[k - 1][v] ];
             ready = true;
         }
@@ -433,6 +2209,15 @@ Graph<ll>::LCA lca;
 lca.buildFromTreeAdj(tree, root);
 int a = lca.query(u,v);
 
+Example 5: Frozen CSR for heavy querying
+Graph<ll> G(n, true); add all edges...
+Graph<ll>::CSR F = G.freeze();          // immutable, contiguous rows
+auto dist = F.breadthFirstSearch(src);  // same API and results as on G
+auto sccs = F.tarjanSCC();
+F.save("graph.bin");                    // binary snapshot ...
+auto H = Graph<ll>::CSR::load("graph.bin");  // ... mmapped back with no per-edge work
+auto R = Graph<ll>::TextLoader::load("roads.gr");  // format from extension, parsed on all cores
+
 Important notes:
 - Nodes are 0-indexed. Convert input if needed.
 - Use long long (Graph<long long>) when weights/sums are large.